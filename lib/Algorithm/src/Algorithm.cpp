@@ -2,179 +2,605 @@
 #include "Algorithm.h"
 #include "House.h"
 #include "VacuumCleaner.h"
-#include <queue>
-#include <tuple>
-#include <map>
-#include <climits>
+#include <algorithm>
+#include <functional>
 #include <cmath>
 
-static const float MOVE_COST = 2.0f;
-static const float ROTATION_COST = 1.5f;
+// Candidate moves per replan for inserting new dirt into the coverage tour
+// and improving it; well under a millisecond on a desktop host, so a few
+// on the ESP32-C3. The tour carries over between replans, so the work
+// adds up. A count, not a time, so a seed always gives the same tour.
+static const long COVERAGE_MOVES_PER_REPLAN = 20000;
+// Enough for the legs of a typical coverage tour plus the trip home
+static const size_t PATH_CACHE_ENTRIES = 32;
+// Cache slots hold paths of up to this many map widths plus heights;
+// longer ones, as in mazes, are planned again on every lookup
+static const int PATH_CACHE_SLOT_CELLS = 2;
+// PathKey::method of the home field descents; searched legs are keyed by
+// their SearchMethod, so neither is served for the other
+static const uint8_t HOME_FIELD_KEY = 0xFF;
+
+// Battery for a path's moves and turns. Battery arithmetic saturates, and
+// a path too long to price is kept one step short of Battery::max(), which
+// means unreachable.
+static Battery pathDrain(Battery moveDrain, int moves, Battery rotateDrain, int turns) {
+    return std::min(moveDrain * moves + rotateDrain * turns,
+                    Battery::max() - Battery::fromRaw(1));
+}
+
+static MovementCommand commandFor(int8_t turn) {
+    return turn == 0 ? MovementCommand{true, 0} : MovementCommand{false, turn};
+}
 
 Algorithm::Algorithm(House* h, VacuumCleaner* v)
     : currentObjective(AlgorithmObjective::CLEANING),
+      plannerMode(PlannerMode::FULL_REPLAN),
       currentPath(),
       house(h),
-      vacuum(v) {
-    // Initialize obstacle map from house
-    for (int i = 0; i < GRID_SIZE; ++i) {
-        for (int j = 0; j < GRID_SIZE; ++j) {
-            obstacleMap[i][j] = house->isObstacle(i, j);
-        }
-    }
+      vacuum(v),
+      sensor(h),
+      map(h->width(), h->height()),
+      numStates(0),
+      jumpLinesValid(false),
+      cleaningSearch(SearchMethod::GRID),
+      returnSearch(SearchMethod::GRID),
+      homeFieldValid(false),
+      obstacleVersion(0),
+      reachableValid(false),
+      weights(),
+      moveCost(toPlanCost(weights.move)),
+      rotateCost(toPlanCost(weights.rotate)),
+      incremental(moveCost, rotateCost, h->width(), h->height()),
+      hierarchical(moveCost, rotateCost, h->width(), h->height()),
+      hierarchicalExpansions(0),
+      tour(moveCost, rotateCost),
+      tourValid(false),
+      pathCache(PATH_CACHE_ENTRIES),
+      coverageBudget(Battery::max()) {
+    resize(house->width(), house->height());
+}
+
+void Algorithm::resize(int width, int height) {
+    map.resize(width, height);
+    numStates = map.cellCount() * NUM_HEADINGS;
+    ws.resize(numStates, moveCost, rotateCost);
+    if (!jumpWs.cost.empty()) jumpWs.resize(numStates, moveCost, rotateCost);
+    // Sized by the first buildHomeField(), so planners that never need
+    // the field never pay for it
+    homeCost.clear();
+    homeFieldValid = false;
+    jumpLinesValid = false;
+    reachableValid = false;
+    passable.resize(map.width(), map.height());
+    reachable.resize(map.width(), map.height());
+    incremental.resize(map.width(), map.height());
+    hierarchical.resize(map.width(), map.height());
+    tourValid = false;
+    // A shortest path passes each state at most once, so the scratch
+    // buffers are sized for numStates commands up front
+    pathCache.resize(PATH_CACHE_SLOT_CELLS * (map.width() + map.height()), numStates);
+    descent.reserve(numStates);
+    steps.reserve(numStates);
+    currentPath.clear();
+    currentPath.reserve(numStates);
+    // Initialize the cell copy from the house
+    cursor = SenseCursor();
+    sensor.senseChanges(map, cursor);
+    obstacleVersion = house->getObstacleVersion();
+    syncHierarchical();
 }
 
 void Algorithm::setObjective(AlgorithmObjective objective) {
+    // Cleaning resumes after a trip home with a new tour
+    if (objective != currentObjective) tourValid = false;
     currentObjective = objective;
     currentPath.clear();
 }
 
-const std::list<MovementCommand>& Algorithm::getCurrentPath() const {
+void Algorithm::setPlannerMode(PlannerMode mode) {
+    if (mode != plannerMode) {
+        incremental.reset();
+        tourValid = false;
+    }
+    plannerMode = mode;
+}
+
+void Algorithm::setSearchMethod(AlgorithmObjective objective, SearchMethod method) {
+    SearchMethod& current = objective == AlgorithmObjective::CLEANING ? cleaningSearch
+                                                                      : returnSearch;
+    current = method;
+}
+
+SearchWorkspace<PlanCost, BinaryHeap<PlanCost>>& Algorithm::jumpWorkspace() {
+    if (static_cast<int>(jumpWs.cost.size()) != numStates) {
+        jumpWs.resize(numStates, moveCost, rotateCost);
+    }
+    if (!jumpLinesValid) {
+        jumpLines.build(map);
+        jumpLinesValid = true;
+    }
+    return jumpWs;
+}
+
+void Algorithm::setMotionCosts(const MotionCosts& costs) {
+    motionCosts = costs;
+}
+
+void Algorithm::setPlannerWeights(const PlannerWeights& w) {
+    weights = w;
+    moveCost = toPlanCost(w.move);
+    rotateCost = toPlanCost(w.rotate);
+    // The bucket queue's window follows the weights
+    ws.resize(numStates, moveCost, rotateCost);
+    incremental.setCosts(moveCost, rotateCost);
+    hierarchical.setCosts(moveCost, rotateCost);
+    tour.setCosts(moveCost, rotateCost);
+    tourValid = false;
+    homeFieldValid = false;
+    pathCache.clear();
+    currentPath.clear();
+}
+
+void Algorithm::setCoverageBudget(Battery battery) {
+    coverageBudget = battery;
+}
+
+const PlanEstimate& Algorithm::getPlanEstimate() const {
+    return planEstimate;
+}
+
+int Algorithm::getLastExpansions() const {
+    bool incrementalPlan = currentObjective == AlgorithmObjective::CLEANING &&
+                           plannerMode == PlannerMode::INCREMENTAL;
+    return ws.pops + jumpWs.pops + hierarchicalExpansions +
+           (incrementalPlan ? incremental.getLastExpansions() : 0);
+}
+
+const PathCache& Algorithm::getPathCache() const {
+    return pathCache;
+}
+
+PathKey Algorithm::pathKey(int x, int y, int yaw, int goalX, int goalY, uint8_t method) const {
+    return {int16_t(x), int16_t(y), int16_t(yaw), int16_t(goalX), int16_t(goalY), method,
+            obstacleVersion};
+}
+
+size_t Algorithm::memoryBytes() const {
+    return sizeof(*this) + map.memoryBytes() - sizeof(map) +
+           ws.memoryBytes() + jumpWs.memoryBytes() + jumpLines.memoryBytes() +
+           homeCost.capacity() * sizeof(PlanCost) +
+           incremental.memoryBytes() - sizeof(incremental) +
+           hierarchical.memoryBytes() - sizeof(hierarchical) + steps.capacity() +
+           passable.memoryBytes() - sizeof(passable) +
+           reachable.memoryBytes() - sizeof(reachable) +
+           tourCells.memoryBytes() - sizeof(tourCells) + tour.memoryBytes() - sizeof(tour) +
+           pathCache.memoryBytes() - sizeof(pathCache) +
+           descent.capacity() * sizeof(MovementCommand) + currentPath.memoryBytes();
+}
+
+void Algorithm::syncMap() {
+    if (house->width() != map.width() || house->height() != map.height()) {
+        resize(house->width(), house->height());
+        return;
+    }
+    sensor.senseChanges(map, cursor);
+    if (house->getObstacleVersion() != obstacleVersion) {
+        obstacleVersion = house->getObstacleVersion();
+        homeFieldValid = false;
+        jumpLinesValid = false;
+        reachableValid = false;
+        tourValid = false;
+        syncHierarchical();
+    }
+}
+
+void Algorithm::syncHierarchical() {
+    for (int y = 0; y < map.height(); ++y) {
+        for (int x = 0; x < map.width(); ++x) {
+            hierarchical.setObstacle(x, y, map.isObstacleAt(x, y));
+        }
+    }
+}
+
+bool Algorithm::planHierarchical(int x, int y, int yaw, int tx, int ty, bool wholePath) {
+    steps.clear();
+    bool found = hierarchical.plan(x, y, yaw, tx, ty, steps, wholePath);
+    hierarchicalExpansions += hierarchical.getLastExpansions();
+    return found;
+}
+
+const BitGrid& Algorithm::reachableFrom(int x, int y) {
+    if (!reachableValid || !reachable.test(x, y)) {
+        passable.setFree(map);
+        // The robot can always leave its own cell
+        passable.set(x, y, true);
+        reachable.floodFrom(passable, x, y);
+        reachableValid = true;
+    }
+    return reachable;
+}
+
+bool Algorithm::hasReachableDirt(int x, int y) {
+    return reachableFrom(x, y).anyOf([this](int cx, int cy) { return map.dirtAt(cx, cy) > 0; });
+}
+
+const MotionPlan& Algorithm::getCurrentPath() const {
     return currentPath;
 }
 
 void Algorithm::calculateNextMove() {
+    ws.pops = 0;
+    jumpWs.pops = 0;
+    hierarchicalExpansions = 0;
+    syncMap();
     if (currentObjective == AlgorithmObjective::RETURN_HOME) {
         calculateReturnPath();
+    } else if (plannerMode == PlannerMode::INCREMENTAL) {
+        calculateIncrementalPath();
+    } else if (plannerMode == PlannerMode::COVERAGE) {
+        calculateCoveragePath();
     } else {
         calculateCleaningPath();
     }
+    estimatePlan();
 }
 
-// Helper to build a coverage path prioritizing dirt levels
+// Goal and heuristic policies for searchStates()
+namespace {
+
+struct NearestDirt {
+    static const bool REVERSE = false;
+    const GridMap& map;
+    bool isGoal(int x, int y) const { return map.dirtAt(x, y) > 0; }
+    PlanCost heuristic(int, int) const { return 0; }
+};
+
+struct ToCell {
+    static const bool REVERSE = false;
+    int tx, ty;
+    PlanCost moveCost;
+    bool isGoal(int x, int y) const { return x == tx && y == ty; }
+    PlanCost heuristic(int x, int y) const {
+        return (std::abs(x - tx) + std::abs(y - ty)) * moveCost;
+    }
+};
+
+// Nearest dirty cell that is not in the coverage tour yet
+struct NewStop {
+    static const bool REVERSE = false;
+    const GridMap& map;
+    const BitGrid& taken;
+    bool isGoal(int x, int y) const { return map.dirtAt(x, y) > 0 && !taken.test(x, y); }
+    PlanCost heuristic(int, int) const { return 0; }
+};
+
+// Backwards from the seeds without a goal, i.e. a full cost-to-go field
+struct WholeField {
+    static const bool REVERSE = true;
+    bool isGoal(int, int) const { return false; }
+    PlanCost heuristic(int, int) const { return 0; }
+};
+
+}  // namespace
+
+// Dijkstra to the nearest dirty cell, or the jump point search equivalent
 void Algorithm::calculateCleaningPath() {
-    // Placeholder: implement coverage with priority weighting by dirt
-    // For now, simple BFS to nearest dirty cell
-    // TODO: replace with A* variant factoring in dirt weight
-    struct Node { int x, y; float cost; };
-    using State = std::pair<float, std::tuple<int,int,int>>;
-    // Get current position and orientation
+    // Left empty when no dirt can be reached
+    currentPath.clear();
     auto [sx, sy] = vacuum->getPosition();
-    int syaw = vacuum->getYaw();
-    
-    // Min-heap: cost, (x,y,yaw)
-    std::priority_queue<State, std::vector<State>, std::greater<State>> pq;
-    std::map<std::tuple<int,int,int>, float> dist;
-    std::map<std::tuple<int,int,int>, std::tuple<int,int,int>> parent;
-    std::map<std::tuple<int,int,int>, MovementCommand> moveCommand;
-
-    pq.push({0.0f, {sx, sy, syaw}});
-    dist[{sx, sy, syaw}] = 0.0f;
-
-    std::tuple<int,int,int> targetState; bool found = false;
-    // Search until we hit a dirty cell
-    while (!pq.empty()) {
-        auto [c, state] = pq.top(); pq.pop();
-        auto [x,y,yaw] = state;
-        if (house->getDirtLevel(x,y) > 0) {
-            targetState = state;
-            found = true;
-            break;
-        }
-        if (c > dist[state]) continue;
-        // Generate moves: forward, rotate left, rotate right
-        std::vector<std::pair<MovementCommand, std::tuple<int,int,int>>> nexts;
-        // Move forward
-        int dx = 0, dy = 0;
-        switch (yaw) {
-            case 0: dy = -1; break;
-            case 90: dx = 1; break;
-            case 180: dy = 1; break;
-            case 270: dx = -1; break;
-        }
-        int nx = x + dx;
-        int ny = y + dy;
-        if (nx>=0 && nx<GRID_SIZE && ny>=0 && ny<GRID_SIZE && !obstacleMap[nx][ny]) {
-            MovementCommand mc{true,0};
-            nexts.push_back({mc,{nx,ny,yaw}});
-        }
-        // Rotate left
-        MovementCommand left{false,-90};
-        nexts.push_back({left,{x,y,(yaw+270)%360}});
-        // Rotate right
-        MovementCommand right{false,90};
-        nexts.push_back({right,{x,y,(yaw+90)%360}});
-
-        for (auto& [cmd, ns] : nexts) {
-            float stepCost = cmd.isMove ? MOVE_COST : ROTATION_COST;
-            float nd = c + stepCost;
-            if (!dist.count(ns) || nd < dist[ns]) {
-                dist[ns] = nd;
-                parent[ns] = state;
-                moveCommand[ns] = cmd;
-                pq.push({nd, ns});
-            }
-        }
+    int start = stateIndex(sx, sy, vacuum->getYaw());
+    // Without this check a search for walled-off dirt would expand every
+    // reachable state before giving up
+    if (!hasReachableDirt(sx, sy)) return;
+    if (cleaningSearch == SearchMethod::JUMP_POINT) {
+        auto& jws = jumpWorkspace();
+        jws.reset();
+        jws.seed(start, 0);
+        int target = jumpSearchStates(jws, jumpLines, map, NearestDirt{map}, moveCost, rotateCost);
+        if (target < 0) return;
+        tracePath(jws, start, target);
+    } else {
+        ws.reset();
+        ws.seed(start, 0);
+        int target = searchStates(ws, map, NearestDirt{map}, moveCost, rotateCost);
+        if (target < 0) return;
+        tracePath(ws, start, target);
     }
-    if (!found) return;
-    // Reconstruct path of commands
-    std::vector<MovementCommand> rev;
-    for (auto cur = targetState; cur != std::tuple<int,int,int>{sx,sy,syaw}; ) {
-        auto cmd = moveCommand[cur];
-        rev.push_back(cmd);
-        cur = parent[cur];
+    appendCommands(descent);
+}
+
+// Reverse Dijkstra from every heading at home (0,0). Each entry holds the
+// exact planning cost, rotations included, of the cheapest way home.
+void Algorithm::buildHomeField() {
+    ws.reset();
+    for (int yaw = 0; yaw < 360; yaw += 90) ws.seed(stateIndex(0, 0, yaw), 0);
+    searchStates(ws, map, WholeField{}, moveCost, rotateCost);
+    homeCost.resize(numStates);
+    for (int s = 0; s < numStates; ++s) homeCost[s] = ws.costOf(s);
+    homeFieldValid = true;
+}
+
+// Cheapest next step towards home from (x,y,yaw); false at home or if cut off
+bool Algorithm::stepTowardsHome(int& x, int& y, int& yaw, MovementCommand& cmd) const {
+    const PlanCost unreachable = unreachableCost<PlanCost>();
+    int h = yaw / 90;
+    if ((x == 0 && y == 0) || homeCost[stateIndex(x, y, yaw)] == unreachable) return false;
+    // Widened so adding a step to an unreachable neighbour can't wrap
+    int64_t best = INT64_MAX;
+    int nx = x + HEADING_DX[h], ny = y + HEADING_DY[h];
+    if (map.inBounds(nx, ny) && !map.isObstacleAt(nx, ny)) {
+        best = int64_t(moveCost) + homeCost[stateIndex(nx, ny, yaw)];
+        cmd = {true, 0};
     }
-    // Commands from start->target, so reverse
-    currentPath.clear();
-    for (auto it = rev.rbegin(); it != rev.rend(); ++it) {
-        currentPath.push_back(*it);
+    const int turns[2] = {-90, 90};
+    for (int t : turns) {
+        int64_t c = int64_t(rotateCost) + homeCost[stateIndex(x, y, (yaw + 360 + t) % 360)];
+        if (c < best) {
+            best = c;
+            cmd = {false, t};
+        }
     }
+    if (cmd.isMove) { x = nx; y = ny; }
+    else yaw = (yaw + 360 + cmd.angle) % 360;
+    return true;
+}
+
+PathView Algorithm::homePath(int x, int y, int yaw) {
+    PathKey key = pathKey(x, y, yaw, 0, 0, HOME_FIELD_KEY);
+    PathView hit;
+    if (pathCache.find(key, hit)) return hit;
+    descent.clear();
+    MovementCommand cmd{};
+    while (stepTowardsHome(x, y, yaw, cmd)) descent.push_back(cmd);
+    return pathCache.insert(key, descent.begin(), descent.end());
 }
 
-// Simple A* to home (0,0)
+// Greedy descent of the cost-to-home field. With jump point search, an A*
+// home instead, and with HIERARCHICAL the first leg of an HPA* path; both
+// bypass pathCache, whose home entries are the field descents
+// energyToHome() prices. The path is left empty when home is cut off.
 void Algorithm::calculateReturnPath() {
-    struct Node { int x, y; int yaw; float g, f; };
-    using State = std::tuple<float, int, int, int>;
-    std::priority_queue<State, std::vector<State>, std::greater<State>> pq;
-    std::map<std::tuple<int,int,int>, float> gScore;
-    std::map<std::tuple<int,int,int>, std::tuple<int,int,int>> parent;
-    std::map<std::tuple<int,int,int>, MovementCommand> moveCommand;
+    currentPath.clear();
+    auto [x, y] = vacuum->getPosition();
+    int yaw = vacuum->getYaw();
+    if (returnSearch == SearchMethod::JUMP_POINT) {
+        if (!searchPathTo(x, y, yaw, 0, 0, returnSearch)) return;
+        appendCommands(descent);
+        return;
+    }
+    if (returnSearch == SearchMethod::HIERARCHICAL) {
+        if (!planHierarchical(x, y, yaw, 0, 0, false)) return;
+        for (int8_t turn : steps) currentPath.push(turn);
+        return;
+    }
+    if (!homeFieldValid) buildHomeField();
+    if (homeCost[stateIndex(x, y, yaw)] == unreachableCost<PlanCost>()) return;
+    for (int8_t turn : homePath(x, y, yaw)) currentPath.push(turn);
+}
+
+Battery Algorithm::energyToHome(int x, int y, int yaw, Battery moveDrain, Battery rotateDrain) {
+    syncMap();
+    if (returnSearch == SearchMethod::HIERARCHICAL) {
+        if (!planHierarchical(x, y, yaw, 0, 0, false)) return Battery::max();
+        return pathDrain(moveDrain, hierarchical.getLastMoves(),
+                         rotateDrain, hierarchical.getLastTurns());
+    }
+    if (!homeFieldValid) buildHomeField();
+    if (homeCost[stateIndex(x, y, yaw)] == unreachableCost<PlanCost>()) return Battery::max();
+    int moves = 0, turns = 0;
+    for (int8_t turn : homePath(x, y, yaw)) ++(turn == 0 ? moves : turns);
+    return pathDrain(moveDrain, moves, rotateDrain, turns);
+}
 
+// Feed cell changes to the D* Lite planner and let it repair its tree.
+// Every dirty cell the robot can reach is a goal; walled-off ones would
+// only seed searches that can never connect.
+void Algorithm::calculateIncrementalPath() {
     auto [sx, sy] = vacuum->getPosition();
-    int syaw = vacuum->getYaw();
-    auto heuristic = [&](int x, int y){ return std::hypot(x, y) * MOVE_COST; };
-
-    pq.push({heuristic(sx,sy), sx, sy, syaw});
-    gScore[{sx,sy,syaw}] = 0.0f;
-
-    std::tuple<int,int,int> target;
-    bool found = false;
-
-    while (!pq.empty()) {
-        auto [f, x, y, yaw] = pq.top(); pq.pop();
-        if (x==0 && y==0) { target = {x,y,yaw}; found=true; break; }
-        float g = gScore[{x,y,yaw}];
-        // Moves: forward, rotate left/right as above
-        std::vector<std::pair<MovementCommand,std::tuple<int,int,int>>> nexts;
-        int dx=0,dy=0;
-        switch(yaw){ case 0: dy=-1; break; case 90: dx=1; break; case 180: dy=1; break; case 270: dx=-1; break; }
-        int nx=x+dx, ny=y+dy;
-        if(nx>=0 && nx<GRID_SIZE && ny>=0 && ny<GRID_SIZE && !obstacleMap[nx][ny]){
-            nexts.push_back({{true,0},{nx,ny,yaw}});
+    const BitGrid& reach = reachableFrom(sx, sy);
+    for (int y = 0; y < map.height(); ++y) {
+        for (int x = 0; x < map.width(); ++x) {
+            incremental.setCell(x, y, map.isObstacleAt(x, y),
+                                map.dirtAt(x, y) > 0 && reach.test(x, y));
         }
-        nexts.push_back({{false,-90},{x,y,(yaw+270)%360}});
-        nexts.push_back({{false,90},{x,y,(yaw+90)%360}});
-
-        for(auto& [cmd, ns] : nexts){
-            float cost = cmd.isMove ? MOVE_COST : ROTATION_COST;
-            float ng = g + cost;
-            auto key = ns;
-            float prev = gScore.count(key) ? gScore[key] : INFINITY;
-            float nf = ng + heuristic(std::get<0>(ns), std::get<1>(ns));
-            if(ng < prev){
-                gScore[key] = ng;
-                parent[key] = {x,y,yaw};
-                moveCommand[key] = cmd;
-                pq.push({nf, std::get<0>(ns), std::get<1>(ns), std::get<2>(ns)});
+    }
+    if (!incremental.plan(sx, sy, vacuum->getYaw(), currentPath)) currentPath.clear();
+}
+
+// Cheapest cost to the dock from any heading at (x,y)
+PlanCost Algorithm::homeDistance(int x, int y) const {
+    int s = stateIndex(x, y, 0);
+    return *std::min_element(homeCost.begin() + s, homeCost.begin() + s + NUM_HEADINGS);
+}
+
+// Battery in planner units, at the forward move's rate; motionCosts must
+// have a non-zero move drain
+int64_t Algorithm::batteryToPlanCost(Battery battery) const {
+    return int64_t(battery.raw()) * moveCost / motionCosts.moveDrain.raw();
+}
+
+PlanCost Algorithm::cleanCost(int dirt) const {
+    if (motionCosts.moveDrain <= Battery()) return 0;
+    return PlanCost(batteryToPlanCost(motionCosts.cleanDrainFor(dirt)));
+}
+
+// Order the dirty cells the coverage budget can pay for into one tour,
+// then stitch the legs together with real searches. The tour is built once
+// per obstacle layout and charge, then only repaired: cleaned cells leave
+// it, new dirt joins it, and a bounded number of improving moves runs per
+// replan. Cells crossed on the way count as cleaned, so later stops that
+// were already driven over are skipped.
+void Algorithm::calculateCoveragePath() {
+    auto [x, y] = vacuum->getPosition();
+    int yaw = vacuum->getYaw();
+    // Leg estimates go round walls by the cost-to-home field
+    if (!homeFieldValid) buildHomeField();
+
+    // Budget in battery units, tour in planner units
+    bool budgeted = coverageBudget != Battery::max() && motionCosts.moveDrain > Battery();
+    int64_t maxCost = budgeted ? batteryToPlanCost(coverageBudget) : INT64_MAX;
+
+    long moves = COVERAGE_MOVES_PER_REPLAN;
+    if (tourValid) {
+        tour.moveStart(x, y, homeDistance(x, y));
+        tour.removeIf([&](int i, int j) {
+            bool gone = map.dirtAt(i, j) == 0 || (i == x && j == y);
+            if (gone) tourCells.set(i, j, false);
+            return gone;
+        });
+        // Dirt that came back since. A cell the tour has no room for stays
+        // marked, so it is not offered again until the tour is rebuilt;
+        // what the move budget can't take now waits for the next replan.
+        const BitGrid& reach = reachableFrom(x, y);
+        reach.forEach([&](int i, int j) {
+            if (moves <= 0 || tourCells.test(i, j) || map.dirtAt(i, j) == 0) return;
+            if (i == x && j == y) return;
+            int d = map.dirtAt(i, j);
+            moves -= tour.insert(i, j, d, homeDistance(i, j), cleanCost(d), maxCost);
+            tourCells.set(i, j, true);
+        });
+        // Start over from what is still dirty once the tour runs dry
+        if (tour.size() == 0) tourValid = false;
+    }
+    if (!tourValid) {
+        // Chain each next-nearest dirty cell by a real search, so the first
+        // order already goes round walls; optimise() then trades distance
+        // for dirt. The robot's own cell is marked to keep it out.
+        tour.reset(x, y, homeDistance(x, y), 0, 0);
+        tourCells.resize(map.width(), map.height());
+        tourCells.set(x, y, true);
+        int s = stateIndex(x, y, yaw);
+        while (true) {
+            ws.reset();
+            ws.seed(s, 0);
+            s = searchStates(ws, map, NewStop{map, tourCells}, moveCost, rotateCost);
+            if (s < 0) break;
+            int i = stateX(s), j = stateY(s), d = map.dirtAt(i, j);
+            tourCells.set(i, j, true);
+            if (!tour.append(i, j, d, homeDistance(i, j), cleanCost(d), maxCost)) break;
+        }
+        tourCells.set(x, y, false);
+        tourValid = true;
+    }
+    tour.optimise(moves);
+    // Cut cells stay marked in tourCells like the ones turned away above
+    if (budgeted) tour.cut(maxCost);
+    int stops = tour.size();
+
+    map.clearVisited();
+    map.setVisitedAt(x, y, true);
+    currentPath.clear();
+    for (int i = 0; i < stops; ++i) {
+        int tx = tour.cellX(i), ty = tour.cellY(i);
+        if (map.isVisitedAt(tx, ty)) continue;
+        appendPathTo(x, y, yaw, tx, ty);
+    }
+}
+
+// Legs planned before against the same obstacles are replayed from the
+// cache, new ones searched for
+bool Algorithm::appendPathTo(int& x, int& y, int& yaw, int tx, int ty) {
+    PathKey key = pathKey(x, y, yaw, tx, ty, uint8_t(cleaningSearch));
+    PathView leg;
+    if (!pathCache.find(key, leg)) {
+        if (!searchPathTo(x, y, yaw, tx, ty, cleaningSearch)) return false;
+        leg = pathCache.insert(key, descent.begin(), descent.end());
+    }
+    int h = yaw / 90;
+    for (int8_t turn : leg) {
+        if (turn == 0) {
+            x += HEADING_DX[h];
+            y += HEADING_DY[h];
+            map.setVisitedAt(x, y, true);
+        } else {
+            h = (h + (turn > 0 ? 1 : NUM_HEADINGS - 1)) % NUM_HEADINGS;
+        }
+        currentPath.push(turn);
+    }
+    yaw = h * 90;
+    return true;
+}
+
+// A* with a Manhattan heuristic to any heading at (tx,ty), or the whole of
+// an HPA* path there
+bool Algorithm::searchPathTo(int x, int y, int yaw, int tx, int ty, SearchMethod method) {
+    ToCell goal{tx, ty, moveCost};
+    int start = stateIndex(x, y, yaw);
+    if (method == SearchMethod::HIERARCHICAL) {
+        if (!planHierarchical(x, y, yaw, tx, ty, true)) return false;
+        descent.clear();
+        for (int8_t turn : steps) descent.push_back(commandFor(turn));
+        return true;
+    }
+    if (method == SearchMethod::JUMP_POINT) {
+        auto& jws = jumpWorkspace();
+        jws.reset();
+        jws.seed(start, goal.heuristic(x, y));
+        int target = jumpSearchStates(jws, jumpLines, map, goal, moveCost, rotateCost);
+        if (target < 0) return false;
+        tracePath(jws, start, target);
+    } else {
+        ws.reset();
+        ws.seed(start, goal.heuristic(x, y));
+        int target = searchStates(ws, map, goal, moveCost, rotateCost);
+        if (target < 0) return false;
+        tracePath(ws, start, target);
+    }
+    return true;
+}
+
+// Replay currentPath from the robot's pose and cost it out
+void Algorithm::estimatePlan() {
+    planEstimate = PlanEstimate();
+    auto [x, y] = vacuum->getPosition();
+    int h = vacuum->getYaw() / 90;
+    // Visited bits mark the cells the plan has already cleaned
+    map.clearVisited();
+    auto clean = [&](int cx, int cy) {
+        int d = map.getDirt(cx, cy);
+        if (d <= 0 || map.isVisited(cx, cy)) return;
+        map.setVisitedAt(cx, cy, true);
+        ++planEstimate.cellsCleaned;
+        planEstimate.battery += motionCosts.cleanDrainFor(d);
+        planEstimate.durationMs += motionCosts.cleanMs;
+    };
+    clean(x, y);
+    for (const MotionPrimitive& p : currentPath) {
+        if (p.op == MotionPrimitive::FORWARD) {
+            for (int i = 0; i < p.count; ++i) {
+                x += HEADING_DX[h];
+                y += HEADING_DY[h];
+                clean(x, y);
             }
+            planEstimate.moves += p.count;
+            planEstimate.battery += motionCosts.moveDrain * p.count;
+            planEstimate.durationMs += motionCosts.moveMs * p.count;
+        } else {
+            int step = p.op == MotionPrimitive::TURN_RIGHT ? 1 : NUM_HEADINGS - 1;
+            h = (h + step * p.count) % NUM_HEADINGS;
+            planEstimate.rotations += p.count;
+            planEstimate.battery += motionCosts.rotateDrain * p.count;
+            planEstimate.durationMs += motionCosts.rotateMs * p.count;
         }
     }
-    if(!found) return;
-    std::vector<MovementCommand> rev;
-    for(auto cur=target; cur!=std::tuple<int,int,int>{sx,sy,syaw};){
-        rev.push_back(moveCommand[cur]);
-        cur = parent[cur];
+}
+
+void Algorithm::appendCommands(const std::vector<MovementCommand>& commands) {
+    for (const MovementCommand& cmd : commands) {
+        currentPath.push(static_cast<int8_t>(cmd.isMove ? 0 : cmd.angle));
     }
-    currentPath.clear();
-    for(auto it=rev.rbegin(); it!=rev.rend(); ++it) currentPath.push_back(*it);
+}
+
+template <typename Workspace>
+void Algorithm::tracePath(const Workspace& w, int start, int target) {
+    descent.clear();
+    for (int cur = target; cur != start; cur = w.parent[cur]) {
+        int8_t turn = w.turn[cur];
+        int count = turn == 0 ? jumpLength(w.parent[cur] / NUM_HEADINGS, cur / NUM_HEADINGS,
+                                           map.width())
+                              : 1;
+        descent.insert(descent.end(), count, commandFor(turn));
+    }
+    // Parents lead from target back to start
+    std::reverse(descent.begin(), descent.end());
 }
@@ -2,9 +2,20 @@
 #ifndef ALGORITHM_H
 #define ALGORITHM_H
 
-#include <list>
+#include <cstdint>
 #include <utility>
 #include <vector>
+#include "BitGrid.h"
+#include "CoverageTour.h"
+#include "GridMap.h"
+#include "GridSearch.h"
+#include "HierarchicalPlanner.h"
+#include "IncrementalPlanner.h"
+#include "JumpSearch.h"
+#include "MotionPlan.h"
+#include "PathCache.h"
+#include "RobotConfig.h"
+#include "Sensor.h"
 
 // Forward declarations
 class House;
@@ -15,12 +26,39 @@ enum class AlgorithmObjective {
     RETURN_HOME
 };
 
+// How CLEANING paths are computed; RETURN_HOME always descends the cached
+// cost-to-home field
+enum class PlannerMode {
+    FULL_REPLAN,   // fresh search on every calculateNextMove()
+    INCREMENTAL,   // D* Lite, repairs the previous search tree
+    COVERAGE       // one optimised tour over every dirty cell
+};
+
+// How the point-to-point and nearest-dirt searches expand states. GRID and
+// JUMP_POINT find paths of the same cost; jump point search skips straight
+// runs over open floor, so it expands far fewer states there. HIERARCHICAL
+// trades a little path cost for searches that stay small on whole floors.
+enum class SearchMethod {
+    GRID,          // every (x, y, heading) state on the way
+    JUMP_POINT,    // only states where turning can matter
+    HIERARCHICAL   // HPA*: cluster graph first, grid only at the ends
+};
+
 struct MovementCommand {
     // true = move forward, false = rotate (use angle to indicate direction)
     bool isMove;
     int angle;  // valid if isMove == false: +90 or -90 degrees
 };
 
+// What executing the current path is expected to take
+struct PlanEstimate {
+    Battery battery;
+    unsigned long durationMs = 0;
+    int moves = 0;
+    int rotations = 0;
+    int cellsCleaned = 0;
+};
+
 class Algorithm {
 public:
     Algorithm(House* h, VacuumCleaner* v);
@@ -28,22 +66,146 @@ public:
     // Set the current objective (CLEANING or RETURN_HOME)
     void setObjective(AlgorithmObjective objective);
 
-    // Returns the computed path of movement commands
-    const std::list<MovementCommand>& getCurrentPath() const;
+    // Choose how paths are (re)computed
+    void setPlannerMode(PlannerMode mode);
+
+    // Search used for one objective's paths: FULL_REPLAN and COVERAGE
+    // cleaning, or the return trip. INCREMENTAL cleaning always runs D* Lite.
+    // HIERARCHICAL only applies to point-to-point paths: coverage legs and
+    // the return trip, of which just the first leg is planned out, and
+    // energyToHome(); otherwise energyToHome() reads the cost-to-home field.
+    // FULL_REPLAN's nearest-dirt search stays on the grid.
+    void setSearchMethod(AlgorithmObjective objective, SearchMethod method);
+
+    // Returns the computed path, one primitive per straight run or turn
+    const MotionPlan& getCurrentPath() const;
 
     // Calculate next set of commands based on objective
     void calculateNextMove();
 
+    // Drain/timing model used for plan estimates and coverage budgeting
+    void setMotionCosts(const MotionCosts& costs);
+
+    // Edge weights of every search; drops the cached trees and home field
+    void setPlannerWeights(const PlannerWeights& weights);
+
+    // Battery a COVERAGE tour may spend; the tour is cut where it runs out,
+    // and its order already puts the dirtiest reachable cells first
+    void setCoverageBudget(Battery battery);
+
+    // Expected battery use and duration of getCurrentPath()
+    const PlanEstimate& getPlanEstimate() const;
+
+    // Battery needed to drive home from the given pose along the planned
+    // return path, given the drain per forward move and per 90° turn.
+    // Battery::max() if home is unreachable.
+    Battery energyToHome(int x, int y, int yaw, Battery moveDrain, Battery rotateDrain);
+
+    // Approximate heap plus object size of the planner state
+    size_t memoryBytes() const;
+
+    // States taken off the open list by the last calculateNextMove()
+    int getLastExpansions() const;
+
+    // Return-home and coverage-leg paths already planned against the
+    // current obstacles; hit/miss counters and memoryBytes() live on it
+    const PathCache& getPathCache() const;
+
 private:
+    // Row-major over cells, headings innermost
+    int stateIndex(int x, int y, int yaw) const {
+        return map.index(x, y) * NUM_HEADINGS + yaw / 90;
+    }
+    int stateX(int s) const { return (s / NUM_HEADINGS) % map.width(); }
+    int stateY(int s) const { return (s / NUM_HEADINGS) / map.width(); }
+
     void calculateCleaningPath();
     void calculateReturnPath();
+    void calculateIncrementalPath();
+    void calculateCoveragePath();
+    // Shortest path from (x,y,yaw) to cell (tx,ty), appended to currentPath;
+    // the pose is advanced and cells passed over are marked visited in map
+    bool appendPathTo(int& x, int& y, int& yaw, int tx, int ty);
+    // A* from (x,y,yaw) to cell (tx,ty) with the given method; the commands
+    // are left in descent
+    bool searchPathTo(int x, int y, int yaw, int tx, int ty, SearchMethod method);
+    // Jump point search workspace, sized on first use; also brings
+    // jumpLines up to date with the obstacles
+    SearchWorkspace<PlanCost, BinaryHeap<PlanCost>>& jumpWorkspace();
+    void estimatePlan();
+    // Size every per-cell and per-state buffer for a width x height house
+    void resize(int width, int height);
+    // Pull the cells that changed since the last sync from the house
+    void syncMap();
+    // Hand the obstacles to the hierarchical planner, which only rebuilds
+    // the clusters whose cells changed
+    void syncHierarchical();
+    // Hierarchical plan into steps; false if unreachable
+    bool planHierarchical(int x, int y, int yaw, int tx, int ty, bool wholePath);
+    void buildHomeField();
+    PlanCost homeDistance(int x, int y) const;
+    int64_t batteryToPlanCost(Battery battery) const;
+    // What cleaning a cell of this dirt level costs, in planner units
+    PlanCost cleanCost(int dirt) const;
+    // Cells the robot at (x,y) can drive to; flood filled again only after
+    // an obstacle change or once the robot is outside the cached region
+    const BitGrid& reachableFrom(int x, int y);
+    bool hasReachableDirt(int x, int y);
+    bool stepTowardsHome(int& x, int& y, int& yaw, MovementCommand& cmd) const;
+    // Commands from (x,y,yaw) down the home field, served from pathCache
+    // when possible. The home field must be valid and reach the pose.
+    PathView homePath(int x, int y, int yaw);
+    // method: HOME_FIELD_KEY for field descents, else the SearchMethod
+    PathKey pathKey(int x, int y, int yaw, int goalX, int goalY, uint8_t method) const;
+    // Append commands to currentPath, joining repeated steps into runs
+    void appendCommands(const std::vector<MovementCommand>& commands);
+    // Commands from start to target along the parents in w, into descent;
+    // a forward jump becomes one move per cell
+    template <typename Workspace>
+    void tracePath(const Workspace& w, int start, int target);
 
     AlgorithmObjective currentObjective;
-    std::list<MovementCommand> currentPath;
+    PlannerMode plannerMode;
+    MotionPlan currentPath;
     House* house;
     VacuumCleaner* vacuum;
-    static const int GRID_SIZE = 20;
-    bool obstacleMap[GRID_SIZE][GRID_SIZE];
+    Sensor sensor;
+    // Current dirt and obstacles copied from the house, kept up to date
+    // through cursor; the visited bits are scratch space for the coverage
+    // and estimate passes
+    GridMap map;
+    SenseCursor cursor;
+    int numStates;
+    SearchWorkspace<PlanCost> ws;
+    // Jumps make for wide priority steps, which a bucket queue would need a
+    // large ring for; the jump search's open list stays small, so a heap
+    SearchWorkspace<PlanCost, BinaryHeap<PlanCost>> jumpWs;
+    JumpLines jumpLines;
+    bool jumpLinesValid;
+    SearchMethod cleaningSearch;
+    SearchMethod returnSearch;
+    // Cost-to-home per state, rebuilt only when an obstacle changes
+    std::vector<PlanCost> homeCost;
+    bool homeFieldValid;
+    uint32_t obstacleVersion;   // house obstacle version the field was built for
+    BitGrid passable;
+    BitGrid reachable;
+    bool reachableValid;
+    PlannerWeights weights;
+    PlanCost moveCost;      // weights in integer planning units
+    PlanCost rotateCost;
+    IncrementalPlanner incremental;
+    HierarchicalPlanner hierarchical;
+    int hierarchicalExpansions;     // by the plans since calculateNextMove()
+    std::vector<int8_t> steps;      // scratch for hierarchical plans
+    CoverageTour tour;
+    BitGrid tourCells;      // cells taken into tour or turned down
+    bool tourValid;         // tour fits the obstacles, weights and objective
+    PathCache pathCache;
+    std::vector<MovementCommand> descent;   // scratch for homePath() and searches
+    MotionCosts motionCosts;
+    PlanEstimate planEstimate;
+    Battery coverageBudget;
 };
 
 #endif  // ALGORITHM_H
@@ -0,0 +1,192 @@
+// CoverageTour.cpp
+#include "CoverageTour.h"
+#include <algorithm>
+#include <cstdlib>
+
+CoverageTour::CoverageTour(PlanCost moveCost, PlanCost rotationCost)
+    : moveCost(moveCost),
+      rotationCost(rotationCost),
+      cleaning(0),
+      movesLeft(0),
+      cursor(1),
+      orPhase(false),
+      quiet(0) {}
+
+void CoverageTour::setCosts(PlanCost newMoveCost, PlanCost newRotationCost) {
+    moveCost = newMoveCost;
+    rotationCost = newRotationCost;
+}
+
+void CoverageTour::reset(int startX, int startY, PlanCost home, int dockX, int dockY) {
+    stops.clear();
+    stops.push_back(makeStop(startX, startY, 0, home, 0));
+    stops.push_back(makeStop(dockX, dockY, 0, 0, 0));
+    cursor = 1;
+    orPhase = false;
+    changed();
+}
+
+PlanCost CoverageTour::leg(const Stop& a, const Stop& b) const {
+    int dx = std::abs(a.x - b.x), dy = std::abs(a.y - b.y);
+    PlanCost grid = (dx + dy) * moveCost + (dx && dy ? rotationCost : 0);
+    // Cells cut off from the dock have no home cost to compare
+    const PlanCost unreachable = unreachableCost<PlanCost>();
+    if (a.home == unreachable || b.home == unreachable) return grid;
+    return std::max(grid, std::abs(a.home - b.home));
+}
+
+void CoverageTour::refresh(int from) {
+    int n = count();
+    arrival.resize(n);
+    weight.resize(n + 1);
+    weightedArrival.resize(n + 1);
+    // The start weighs nothing
+    arrival[0] = weight[0] = weight[1] = weightedArrival[0] = weightedArrival[1] = 0;
+    for (int k = std::max(from, 1); k < n; ++k) {
+        arrival[k] = arrival[k - 1] + leg(k - 1, k);
+        // Reaching the dock weighs as much as every stop before it
+        int64_t w = k + 1 < n ? value(stops[k]) : weight[k];
+        weight[k + 1] = weight[k] + w;
+        weightedArrival[k + 1] = weightedArrival[k] + w * arrival[k];
+    }
+}
+
+void CoverageTour::changed() {
+    cleaning = 0;
+    for (const Stop& s : stops) cleaning += s.clean;
+    refresh(1);
+    quiet = 0;
+}
+
+bool CoverageTour::append(int x, int y, int d, PlanCost home, PlanCost clean, int64_t maxCost) {
+    Stop c = makeStop(x, y, d, home, clean);
+    int last = count() - 2;
+    if (cost() + leg(stops[last], c) + clean > maxCost) return false;
+    // Keep the dock last; only the new stop and the dock need recomputing
+    stops.insert(stops.end() - 1, c);
+    cleaning += clean;
+    refresh(last + 1);
+    quiet = 0;
+    return true;
+}
+
+void CoverageTour::moveStart(int x, int y, PlanCost home) {
+    Stop& start = stops[0];
+    if (start.x == x && start.y == y && start.home == home) return;
+    start = makeStop(x, y, 0, home, 0);
+    changed();
+}
+
+long CoverageTour::insert(int x, int y, int d, PlanCost home, PlanCost clean,
+                          int64_t maxCost) {
+    Stop c = makeStop(x, y, d, home, clean);
+    int n = count();
+    int64_t room = maxCost - cost() - clean;
+    int best = -1;
+    int64_t bestDelta = INT64_MAX;
+    for (int p = 0; p + 1 < n; ++p) {
+        PlanCost in = leg(stops[p], c), out = leg(c, stops[p + 1]);
+        // cost() stops at the last stop, so a new last stop adds only its leg in
+        int64_t longer = p + 2 < n ? in + out - leg(p, p + 1) : in;
+        if (longer > room) continue;
+        int64_t a = arrival[p] + in;
+        // Everything after the new stop arrives later by its detour
+        int64_t delta = value(c) * a + (a + out - arrival[p + 1]) * weightOf(p + 1, n);
+        if (delta < bestDelta) {
+            bestDelta = delta;
+            best = p;
+        }
+    }
+    if (best >= 0) {
+        stops.insert(stops.begin() + best + 1, c);
+        changed();
+    }
+    return n;
+}
+
+void CoverageTour::cut(int64_t maxCost) {
+    int n = count(), keep = 1;
+    int64_t cleaned = 0;
+    for (; keep + 1 < n; ++keep) {
+        cleaned += stops[keep].clean;
+        if (arrival[keep] + cleaned > maxCost) break;
+    }
+    if (keep + 1 == n) return;
+    stops[keep] = stops[n - 1];
+    stops.resize(keep + 1);
+    changed();
+}
+
+// Reverse the stops at i .. j. Reversed, the stop at k arrives at
+// a + arrival[j] - arrival[k], where a is the new arrival at j.
+bool CoverageTour::twoOptAt(int i) {
+    int n = count();
+    movesLeft -= n - i - 2;
+    // The dock stays last, so j + 1 is always a stop
+    for (int j = i + 1; j + 1 < n; ++j) {
+        int64_t a = arrival[i - 1] + leg(i - 1, j);
+        int64_t next = a + arrival[j] - arrival[i] + leg(i, j + 1);
+        int64_t delta = (a + arrival[j]) * weightOf(i, j + 1) - 2 * weightedOf(i, j + 1) +
+                        (next - arrival[j + 1]) * weightOf(j + 1, n);
+        if (delta < 0) {
+            std::reverse(stops.begin() + i, stops.begin() + j + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Move the run of one to three stops starting at i to after position p.
+// The stops between the run's old and new place, and those after both,
+// each shift by one amount, so every candidate costs O(1).
+bool CoverageTour::orOptAt(int i) {
+    int n = count();
+    // Neither the run nor its new place may pass the dock
+    for (int len = 1; len <= 3 && i + len < n; ++len) {
+        int last = i + len - 1;
+        int64_t runWeight = weightOf(i, last + 1);
+        int64_t inner = arrival[last] - arrival[i];
+        movesLeft -= n - 1;
+        for (int p = 0; p + 1 < n; ++p) {
+            if (p >= i - 1 && p <= last) continue;
+            int64_t delta;
+            if (p < i) {
+                // p, run, p+1 .. i-1, last+1 ..
+                int64_t a = arrival[p] + leg(p, i);
+                int64_t between = a + inner + leg(last, p + 1) - arrival[p + 1];
+                int64_t after = arrival[i - 1] + between + leg(i - 1, last + 1) -
+                                arrival[last + 1];
+                delta = (a - arrival[i]) * runWeight + between * weightOf(p + 1, i) +
+                        after * weightOf(last + 1, n);
+            } else {
+                // i-1, last+1 .. p, run, p+1 ..
+                int64_t between = arrival[i - 1] + leg(i - 1, last + 1) - arrival[last + 1];
+                int64_t a = arrival[p] + between + leg(p, i);
+                int64_t after = a + inner + leg(last, p + 1) - arrival[p + 1];
+                delta = between * weightOf(last + 1, p + 1) + (a - arrival[i]) * runWeight +
+                        after * weightOf(p + 1, n);
+            }
+            if (delta >= 0) continue;
+            auto s = stops.begin();
+            if (p < i) std::rotate(s + p + 1, s + i, s + last + 1);
+            else       std::rotate(s + i, s + last + 1, s + p + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void CoverageTour::optimise(long maxMoves) {
+    movesLeft = maxMoves;
+    // Settled once a whole round of both passes found nothing to improve
+    while (movesLeft > 0 && quiet < 2 * size()) {
+        if (cursor > size()) {
+            cursor = 1;
+            orPhase = !orPhase;
+        }
+        bool improved = orPhase ? orOptAt(cursor) : twoOptAt(cursor);
+        ++cursor;
+        if (improved) changed();
+        else ++quiet;
+    }
+}
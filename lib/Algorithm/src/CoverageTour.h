@@ -0,0 +1,130 @@
+// CoverageTour.h
+#ifndef COVERAGE_TOUR_H
+#define COVERAGE_TOUR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "GridSearch.h"
+
+// Visiting order for a set of dirty cells, starting at the robot and
+// heading for the dock. The order minimises the weighted arrival cost,
+// sum(weight * arrival), where a cell weighs a fixed amount plus its dirt
+// and the dock weighs as much as every cell together, so nearby and dirty
+// cells come first and the tour still ends close to home. Legs are
+// estimated as forward moves plus one turn whenever both axes change, or
+// the difference of the two cells' cost to home where that is larger,
+// which keeps cells on either side of a wall apart. Costs are integer
+// PlanCost units.
+//
+// The tour is kept between replans: the start follows the robot, cleaned
+// cells are removed, new dirt is inserted where it costs least, and
+// optimise() picks up where the previous call stopped.
+class CoverageTour {
+public:
+    CoverageTour(PlanCost moveCost, PlanCost rotationCost);
+
+    // Weights for tours built after the next reset()
+    void setCosts(PlanCost moveCost, PlanCost rotationCost);
+
+    // Start a new, empty tour at the robot's cell. home is a cell's cost to
+    // the dock, unreachableCost() if it has none; clean what cleaning it
+    // costs.
+    void reset(int startX, int startY, PlanCost home, int dockX, int dockY);
+    // Add a stop after the last one unless that takes cost() past maxCost
+    bool append(int x, int y, int dirt, PlanCost home, PlanCost clean, int64_t maxCost);
+
+    // The robot moved to (x, y)
+    void moveStart(int x, int y, PlanCost home);
+    // Remove every stop for which drop(x, y) holds
+    template <typename F>
+    void removeIf(F drop);
+    // Add a stop where it raises the objective least without taking cost()
+    // past maxCost. Returns the positions tried, to be charged against a
+    // move budget; the cell is left out if it fits nowhere.
+    long insert(int x, int y, int dirt, PlanCost home, PlanCost clean, int64_t maxCost);
+
+    // Apply improving 2-opt and Or-opt moves until maxMoves candidate moves
+    // have been tried or none is left. Each call continues the scan where
+    // the last one stopped, so a small budget per replan still reaches the
+    // whole tour. A move count rather than a time limit keeps the tour the
+    // same for the same cells, however loaded the host is.
+    void optimise(long maxMoves);
+
+    // Drop the stops from the first one that takes cost() past maxCost
+    void cut(int64_t maxCost);
+
+    // Estimated cost of reaching and cleaning every stop, without the way
+    // home from the last one. 64 bits, as a tour over a large map can
+    // exceed a single PlanCost.
+    int64_t cost() const { return arrival[count() - 2] + cleaning; }
+
+    // Heap plus object size
+    size_t memoryBytes() const {
+        return sizeof(*this) + stops.capacity() * sizeof(Stop) +
+               (arrival.capacity() + weight.capacity() + weightedArrival.capacity()) *
+                   sizeof(int64_t);
+    }
+
+    int size() const { return count() - 2; }
+    int cellX(int i) const { return stops[i + 1].x; }
+    int cellY(int i) const { return stops[i + 1].y; }
+
+private:
+    struct Stop {
+        int16_t x, y;
+        uint8_t dirt;
+        PlanCost home;
+        PlanCost clean;
+    };
+
+    // Four times the heaviest dirt per cell, so dirt orders the cells
+    // without trading many of them for one dirtier one
+    static int64_t value(const Stop& s) { return 4 * GridMap::MAX_DIRT_LEVEL + s.dirt; }
+    static Stop makeStop(int x, int y, int dirt, PlanCost home, PlanCost clean) {
+        return {static_cast<int16_t>(x), static_cast<int16_t>(y), static_cast<uint8_t>(dirt),
+                home, clean};
+    }
+    int count() const { return static_cast<int>(stops.size()); }
+    PlanCost leg(const Stop& a, const Stop& b) const;
+    PlanCost leg(int i, int j) const { return leg(stops[i], stops[j]); }
+    // Weight and weight * arrival summed over positions i .. j - 1
+    int64_t weightOf(int i, int j) const { return weight[j] - weight[i]; }
+    int64_t weightedOf(int i, int j) const { return weightedArrival[j] - weightedArrival[i]; }
+    // Recompute arrival costs and prefix sums from position from on
+    void refresh(int from);
+    // First improving move for the stop at position i, applied; both
+    // charge the candidates they try against movesLeft
+    bool twoOptAt(int i);
+    bool orOptAt(int i);
+    void changed();
+
+    PlanCost moveCost;
+    PlanCost rotationCost;
+
+    // Position 0 is the robot and stays first, the dock stays last. Storage
+    // is kept across resets, so only a larger tour than before allocates.
+    std::vector<Stop> stops;
+    std::vector<int64_t> arrival;           // estimated cost from the start
+    std::vector<int64_t> weight;            // prefix sums, one longer than stops
+    std::vector<int64_t> weightedArrival;
+    int64_t cleaning;   // clean cost of every stop
+    long movesLeft;     // candidate moves optimise() may still try
+    int cursor;         // position optimise() resumes at
+    bool orPhase;       // scanning Or-opt moves rather than 2-opt
+    int quiet;          // positions scanned since the last improvement
+};
+
+template <typename F>
+void CoverageTour::removeIf(F drop) {
+    size_t kept = 1, last = stops.size() - 1;
+    for (size_t i = 1; i < last; ++i) {
+        if (!drop(stops[i].x, stops[i].y)) stops[kept++] = stops[i];
+    }
+    if (kept == last) return;
+    stops[kept++] = stops[last];
+    stops.resize(kept);
+    changed();
+}
+
+#endif  // COVERAGE_TOUR_H
@@ -0,0 +1,164 @@
+// GridSearch.h
+#ifndef GRID_SEARCH_H
+#define GRID_SEARCH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "GridMap.h"
+#include "SearchQueues.h"
+
+// Search over (x, y, heading) states, indexed cell * 4 + yaw / 90. Every
+// planner that looks for a path on the grid goes through searchStates();
+// the goal test, heuristic, cost type and search direction are template
+// parameters, so each instantiation compiles down to its own tight loop.
+
+static const int NUM_HEADINGS = 4;
+
+// Forward step per heading index (yaw / 90): up, right, down, left
+constexpr int HEADING_DX[NUM_HEADINGS] = {0, 1, 0, -1};
+constexpr int HEADING_DY[NUM_HEADINGS] = {-1, 0, 1, 0};
+
+// Planning costs in 1/COST_SCALE units of a planner weight
+typedef int32_t PlanCost;
+static const int COST_SCALE = 16;
+
+// Weights are clamped so no path over the largest map can overflow
+inline PlanCost toPlanCost(float weight) {
+    const float maxWeight = 64.0f;
+    float w = std::min(std::max(weight, 1.0f / COST_SCALE), maxWeight);
+    return static_cast<PlanCost>(std::lround(w * COST_SCALE));
+}
+
+template <typename Cost>
+constexpr Cost unreachableCost() {
+    return std::numeric_limits<Cost>::has_infinity ? std::numeric_limits<Cost>::infinity()
+                                                   : std::numeric_limits<Cost>::max();
+}
+
+// Integer costs go through Dial's bucket queue, anything else a heap
+template <typename Cost>
+using DefaultQueue = typename std::conditional<std::is_integral<Cost>::value,
+                                               BucketQueue<Cost>, BinaryHeap<Cost>>::type;
+
+// Dense search state. Lives as long as its owner; an entry is only valid
+// while its stamp matches the current generation, so a new search never
+// has to clear.
+template <typename Cost, typename Queue = DefaultQueue<Cost>>
+struct SearchWorkspace {
+    std::vector<Cost> cost;
+    std::vector<int32_t> parent;
+    std::vector<int8_t> turn;      // 0 = forward, otherwise +90/-90 rotation
+    std::vector<uint16_t> stamp;
+    uint16_t generation = 0;
+
+    Queue queue;
+    int pops = 0;   // queue pops since the counter was last cleared
+
+    // Sized for the weights searchStates() will be called with: along an
+    // edge a priority rises by at most a turn, or a move plus moveCost of
+    // heuristic
+    void resize(int numStates, Cost moveCost, Cost rotateCost) {
+        cost.assign(numStates, unreachableCost<Cost>());
+        parent.assign(numStates, 0);
+        turn.assign(numStates, 0);
+        stamp.assign(numStates, 0);
+        generation = 0;
+        queue.resize(numStates, std::max(moveCost + moveCost, rotateCost));
+    }
+
+    void reset() {
+        // Stamps from the previous generation become stale automatically;
+        // only on wrap-around do they need to be wiped so none look current
+        if (++generation == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            generation = 1;
+        }
+        queue.clear();
+    }
+
+    bool seen(int s) const { return stamp[s] == generation; }
+    Cost costOf(int s) const { return seen(s) ? cost[s] : unreachableCost<Cost>(); }
+
+    void relax(int s, Cost c, int from, int8_t cmd) {
+        cost[s] = c;
+        parent[s] = from;
+        turn[s] = cmd;
+        stamp[s] = generation;
+    }
+
+    void push(Cost priority, int s) { queue.push(priority, s); }
+
+    QueueEntry<Cost> pop() {
+        ++pops;
+        return queue.pop();
+    }
+
+    // Start state of a search, at cost zero
+    void seed(int s, Cost priority) {
+        relax(s, Cost(0), s, 0);
+        push(priority, s);
+    }
+
+    bool empty() const { return queue.empty(); }
+
+    size_t memoryBytes() const {
+        return cost.capacity() * sizeof(Cost) + parent.capacity() * sizeof(int32_t) +
+               turn.capacity() + stamp.capacity() * sizeof(uint16_t) +
+               queue.memoryBytes();
+    }
+};
+
+// Best-first search from the states seeded into ws until a state passes
+// Policy::isGoal(). Returns that state, or -1 once the queue runs dry.
+// Policy supplies
+//   static const bool REVERSE   search predecessors instead of successors
+//   bool isGoal(int x, int y)
+//   Cost heuristic(int x, int y) consistent lower bound; 0 for Dijkstra.
+//                               Changes by at most moveCost per cell, so a
+//                               bucket queue's window stays small.
+// A forward move is legal when its destination cell is in bounds and free.
+template <typename Cost, typename Queue, typename Policy>
+int searchStates(SearchWorkspace<Cost, Queue>& ws, const GridMap& map, const Policy& policy,
+                 Cost moveCost, Cost rotateCost) {
+    const int width = map.width();
+    const int step = Policy::REVERSE ? -1 : 1;
+    auto improve = [&](int s, Cost c, int from, int8_t cmd, Cost h) {
+        if (c < ws.costOf(s)) {
+            ws.relax(s, c, from, cmd);
+            ws.push(c + h, s);
+        }
+    };
+    while (!ws.empty()) {
+        QueueEntry<Cost> top = ws.pop();
+        int s = top.state;
+        int cell = s / NUM_HEADINGS;
+        int h = s % NUM_HEADINGS;
+        int x = cell % width;
+        int y = cell / width;
+        Cost g = ws.cost[s];
+        Cost hHere = policy.heuristic(x, y);
+        // Superseded by a cheaper entry pushed later
+        if (top.priority > g + hHere) continue;
+        if (policy.isGoal(x, y)) return s;
+
+        int nx = x + step * HEADING_DX[h];
+        int ny = y + step * HEADING_DY[h];
+        if (map.inBounds(nx, ny) &&
+            !(Policy::REVERSE ? map.isObstacleAt(x, y) : map.isObstacleAt(nx, ny))) {
+            improve(map.index(nx, ny) * NUM_HEADINGS + h, g + moveCost, s, 0,
+                    policy.heuristic(nx, ny));
+        }
+        improve(cell * NUM_HEADINGS + (h + NUM_HEADINGS - 1) % NUM_HEADINGS,
+                g + rotateCost, s, -90, hHere);
+        improve(cell * NUM_HEADINGS + (h + 1) % NUM_HEADINGS,
+                g + rotateCost, s, 90, hHere);
+    }
+    return -1;
+}
+
+#endif  // GRID_SEARCH_H
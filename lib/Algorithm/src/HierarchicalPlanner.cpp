@@ -0,0 +1,394 @@
+// HierarchicalPlanner.cpp
+#include "HierarchicalPlanner.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+// Every state the seeds reach, forwards or backwards
+template <bool BACKWARDS>
+struct WholeCluster {
+    static const bool REVERSE = BACKWARDS;
+    bool isGoal(int, int) const { return false; }
+    PlanCost heuristic(int, int) const { return 0; }
+};
+
+// Heading of a move from one cell to the one east or south of it, and back
+const int EAST = 1, SOUTH = 2, WEST = 3, NORTH = 0;
+
+}  // namespace
+
+HierarchicalPlanner::HierarchicalPlanner(PlanCost moveCost, PlanCost rotationCost, int width,
+                                         int height)
+    : moveCost(moveCost),
+      rotationCost(rotationCost),
+      width(0),
+      height(0),
+      clustersX(0),
+      clustersY(0),
+      anyDirty(true),
+      generation(0),
+      box(CLUSTER_SIZE, CLUSTER_SIZE),
+      originX(0),
+      originY(0),
+      lastMoves(0),
+      lastTurns(0),
+      expansions(0),
+      rebuilt(0) {
+    local.resize(CLUSTER_SIZE * CLUSTER_SIZE * NUM_HEADINGS, moveCost, rotationCost);
+    resize(width, height);
+}
+
+void HierarchicalPlanner::setCosts(PlanCost newMoveCost, PlanCost newRotationCost) {
+    moveCost = newMoveCost;
+    rotationCost = newRotationCost;
+    local.resize(CLUSTER_SIZE * CLUSTER_SIZE * NUM_HEADINGS, moveCost, rotationCost);
+    // Transitions only depend on the cells, the links inside clusters on
+    // the weights as well
+    for (Cluster& c : clusters) c.dirty = true;
+    anyDirty = true;
+}
+
+void HierarchicalPlanner::resize(int w, int h) {
+    width = w;
+    height = h;
+    clustersX = (w + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    clustersY = (h + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    blocked.assign(static_cast<size_t>(w) * h, 0);
+    clusters.assign(static_cast<size_t>(clustersX) * clustersY, Cluster());
+    eastBorders.assign(clusters.size(), Border());
+    southBorders.assign(clusters.size(), Border());
+    nodes.clear();
+    freeNodes.clear();
+    labels.clear();
+    goalLinks.clear();
+    generation = 0;
+    anyDirty = true;
+}
+
+void HierarchicalPlanner::setObstacle(int x, int y, bool obstacle) {
+    uint8_t& cell = blocked[static_cast<size_t>(y) * width + x];
+    if (cell == static_cast<uint8_t>(obstacle)) return;
+    cell = obstacle;
+    markCell(x, y);
+}
+
+// A cell on the edge of its cluster also decides the transitions across
+// that edge, which belong to the neighbour as much
+void HierarchicalPlanner::markCell(int x, int y) {
+    int cx = x / CLUSTER_SIZE, cy = y / CLUSTER_SIZE;
+    int c = cy * clustersX + cx;
+    clusters[c].dirty = true;
+    if (x % CLUSTER_SIZE == CLUSTER_SIZE - 1 && cx + 1 < clustersX) {
+        eastBorders[c].dirty = true;
+        clusters[c + 1].dirty = true;
+    }
+    if (x % CLUSTER_SIZE == 0 && cx > 0) {
+        eastBorders[c - 1].dirty = true;
+        clusters[c - 1].dirty = true;
+    }
+    if (y % CLUSTER_SIZE == CLUSTER_SIZE - 1 && cy + 1 < clustersY) {
+        southBorders[c].dirty = true;
+        clusters[c + clustersX].dirty = true;
+    }
+    if (y % CLUSTER_SIZE == 0 && cy > 0) {
+        southBorders[c - clustersX].dirty = true;
+        clusters[c - clustersX].dirty = true;
+    }
+    anyDirty = true;
+}
+
+void HierarchicalPlanner::repair() {
+    rebuilt = 0;
+    if (!anyDirty) return;
+    for (int c = 0; c < static_cast<int>(clusters.size()); ++c) {
+        if (eastBorders[c].dirty) rebuildBorder(c, true);
+        if (southBorders[c].dirty) rebuildBorder(c, false);
+    }
+    for (int c = 0; c < static_cast<int>(clusters.size()); ++c) {
+        if (clusters[c].dirty) rebuildCluster(c);
+    }
+    anyDirty = false;
+}
+
+void HierarchicalPlanner::rebuildBorder(int c, bool east) {
+    Border& border = east ? eastBorders[c] : southBorders[c];
+    border.dirty = false;
+    for (int id : border.nodes) freeNode(id);
+    border.nodes.clear();
+    int cx = c % clustersX, cy = c / clustersX;
+    if (east ? cx + 1 >= clustersX : cy + 1 >= clustersY) return;
+
+    // Cell pairs along the border: a inside c, b across it
+    int ax = east ? (cx + 1) * CLUSTER_SIZE - 1 : cx * CLUSTER_SIZE;
+    int ay = east ? cy * CLUSTER_SIZE : (cy + 1) * CLUSTER_SIZE - 1;
+    int length = std::min(CLUSTER_SIZE, east ? height - ay : width - ax);
+    int dx = east ? 0 : 1, dy = east ? 1 : 0;
+    int bx = ax + (east ? 1 : 0), by = ay + (east ? 0 : 1);
+    auto passable = [&](int i) {
+        return !blocked[static_cast<size_t>(ay + i * dy) * width + ax + i * dx] &&
+               !blocked[static_cast<size_t>(by + i * dy) * width + bx + i * dx];
+    };
+    int heading = east ? EAST : SOUTH;
+    for (int i = 0; i < length;) {
+        if (!passable(i)) {
+            ++i;
+            continue;
+        }
+        int run = 0;
+        while (i + run < length && passable(i + run)) ++run;
+        // Short gaps get one transition in the middle, long ones one at
+        // each end so paths along the border need not detour
+        int first = run < SPLIT_RUN ? i + run / 2 : i;
+        int last = run < SPLIT_RUN ? first : i + run - 1;
+        for (int t = first; t <= last; t += std::max(1, last - first)) {
+            addTransition(border, ax + t * dx, ay + t * dy, bx + t * dx, by + t * dy, heading);
+        }
+        i += run;
+    }
+}
+
+// Nodes both ways across the pair of cells a (west or north) and b
+void HierarchicalPlanner::addTransition(Border& border, int ax, int ay, int bx, int by,
+                                        int heading) {
+    int back = heading == EAST ? WEST : NORTH;
+    int ca = clusterOf(ax, ay), cb = clusterOf(bx, by);
+    int leaveA = allocNode(stateIndex(ax, ay, heading), ca, false);
+    int arriveB = allocNode(stateIndex(bx, by, heading), cb, true);
+    int leaveB = allocNode(stateIndex(bx, by, back), cb, false);
+    int arriveA = allocNode(stateIndex(ax, ay, back), ca, true);
+    nodes[leaveA].edges.push_back({arriveB, 1, 0});
+    nodes[leaveB].edges.push_back({arriveA, 1, 0});
+    border.nodes.insert(border.nodes.end(), {leaveA, arriveB, leaveB, arriveA});
+}
+
+int HierarchicalPlanner::allocNode(int state, int cluster, bool arriving) {
+    int id;
+    if (freeNodes.empty()) {
+        id = static_cast<int>(nodes.size());
+        nodes.emplace_back();
+    } else {
+        id = freeNodes.back();
+        freeNodes.pop_back();
+    }
+    Node& n = nodes[id];
+    n.state = state;
+    n.cluster = cluster;
+    n.arriving = arriving;
+    n.edges.clear();
+    return id;
+}
+
+void HierarchicalPlanner::freeNode(int id) {
+    nodes[id].cluster = -1;
+    nodes[id].edges.clear();
+    freeNodes.push_back(id);
+}
+
+// Collect the nodes on the cluster's four borders, then link every
+// arriving node to each leaving node it reaches without leaving the cluster
+void HierarchicalPlanner::rebuildCluster(int c) {
+    Cluster& cluster = clusters[c];
+    cluster.dirty = false;
+    cluster.arriving.clear();
+    cluster.leaving.clear();
+    int cx = c % clustersX, cy = c / clustersX;
+    const Border* sides[4] = {&eastBorders[c], &southBorders[c],
+                              cx > 0 ? &eastBorders[c - 1] : nullptr,
+                              cy > 0 ? &southBorders[c - clustersX] : nullptr};
+    for (const Border* side : sides) {
+        if (!side) continue;
+        for (int id : side->nodes) {
+            if (nodes[id].cluster != c) continue;
+            (nodes[id].arriving ? cluster.arriving : cluster.leaving).push_back(id);
+        }
+    }
+    ++rebuilt;
+    if (cluster.arriving.empty()) return;
+
+    loadCluster(c);
+    for (int from : cluster.arriving) {
+        Node& n = nodes[from];
+        n.edges.clear();
+        searchFrom(toLocal(n.state));
+        for (int to : cluster.leaving) {
+            int s = toLocal(nodes[to].state);
+            if (!local.seen(s)) continue;
+            int moves, turns;
+            countSteps(s, moves, turns);
+            n.edges.push_back({to, static_cast<int16_t>(moves), static_cast<int16_t>(turns)});
+        }
+    }
+}
+
+void HierarchicalPlanner::loadCluster(int c) {
+    originX = (c % clustersX) * CLUSTER_SIZE;
+    originY = (c / clustersX) * CLUSTER_SIZE;
+    for (int y = 0; y < CLUSTER_SIZE; ++y) {
+        for (int x = 0; x < CLUSTER_SIZE; ++x) {
+            int gx = originX + x, gy = originY + y;
+            bool outside = gx >= width || gy >= height;
+            box.setObstacleAt(x, y, outside || blocked[static_cast<size_t>(gy) * width + gx]);
+        }
+    }
+}
+
+int HierarchicalPlanner::toLocal(int state) const {
+    int cell = state / NUM_HEADINGS;
+    int x = cell % width - originX, y = cell / width - originY;
+    return box.index(x, y) * NUM_HEADINGS + state % NUM_HEADINGS;
+}
+
+void HierarchicalPlanner::searchFrom(int s) {
+    local.reset();
+    local.seed(s, 0);
+    searchStates(local, box, WholeCluster<false>{}, moveCost, rotationCost);
+}
+
+int HierarchicalPlanner::bestArrival(int x, int y) const {
+    int best = -1;
+    for (int h = 0; h < NUM_HEADINGS; ++h) {
+        int s = box.index(x - originX, y - originY) * NUM_HEADINGS + h;
+        if (local.seen(s) && (best < 0 || local.cost[s] < local.cost[best])) best = s;
+    }
+    return best;
+}
+
+void HierarchicalPlanner::countSteps(int s, int& moves, int& turns) const {
+    moves = turns = 0;
+    for (; local.parent[s] != s; s = local.parent[s]) ++(local.turn[s] == 0 ? moves : turns);
+}
+
+void HierarchicalPlanner::appendSteps(int s, std::vector<int8_t>& out) {
+    steps.clear();
+    for (; local.parent[s] != s; s = local.parent[s]) steps.push_back(local.turn[s]);
+    // Parents lead back to the seed
+    out.insert(out.end(), steps.rbegin(), steps.rend());
+}
+
+bool HierarchicalPlanner::plan(int sx, int sy, int syaw, int tx, int ty,
+                               std::vector<int8_t>& out, bool wholePath) {
+    local.pops = 0;
+    repair();
+    int startCluster = clusterOf(sx, sy), goalCluster = clusterOf(tx, ty);
+    const int goal = static_cast<int>(nodes.size()), start = goal + 1;
+    if (labels.size() < nodes.size() + 2) {
+        labels.resize(nodes.size() + 2, Label{0, 0, 0, 0, 0});
+        goalLinks.resize(nodes.size(), GoalLink{0, 0, 0});
+    }
+    if (++generation == 0) {
+        for (Label& l : labels) l.stamp = 0;
+        for (GoalLink& l : goalLinks) l.stamp = 0;
+        generation = 1;
+    }
+
+    // Backwards from the goal over its cluster: the way in from each
+    // arriving node
+    loadCluster(goalCluster);
+    local.reset();
+    for (int h = 0; h < NUM_HEADINGS; ++h) local.seed(toLocal(stateIndex(tx, ty, h)), 0);
+    searchStates(local, box, WholeCluster<true>{}, moveCost, rotationCost);
+    for (int id : clusters[goalCluster].arriving) {
+        int s = toLocal(nodes[id].state);
+        if (!local.seen(s)) continue;
+        int moves, turns;
+        countSteps(s, moves, turns);
+        goalLinks[id] = {static_cast<int16_t>(moves), static_cast<int16_t>(turns), generation};
+    }
+
+    // Forwards from the start over its cluster; left in local for the
+    // first leg
+    loadCluster(startCluster);
+    searchFrom(toLocal(stateIndex(sx, sy, syaw / 90)));
+    expansions = local.pops;
+
+    open.clear();
+    auto heuristic = [&](int id) {
+        int cell = nodes[id].state / NUM_HEADINGS;
+        return (std::abs(cell % width - tx) + std::abs(cell / width - ty)) * moveCost;
+    };
+    auto relax = [&](int id, int from, int moves, int turns) {
+        const Label& f = labels[from];
+        Label& l = labels[id];
+        PlanCost g = f.g + pathCost(moves, turns);
+        if (l.stamp == generation && l.g <= g) return;
+        l = {g, from, f.moves + moves, f.turns + turns, generation};
+        open.push(g + (id == goal ? 0 : heuristic(id)), id);
+    };
+    labels[start] = {0, start, 0, 0, generation};
+    for (int id : clusters[startCluster].leaving) {
+        int s = toLocal(nodes[id].state);
+        if (!local.seen(s)) continue;
+        int moves, turns;
+        countSteps(s, moves, turns);
+        relax(id, start, moves, turns);
+    }
+    if (startCluster == goalCluster) {
+        int s = bestArrival(tx, ty);
+        if (s >= 0) {
+            int moves, turns;
+            countSteps(s, moves, turns);
+            relax(goal, start, moves, turns);
+        }
+    }
+    while (!open.empty()) {
+        QueueEntry<PlanCost> top = open.pop();
+        int id = top.state;
+        if (id == goal) break;
+        const Label& l = labels[id];
+        if (top.priority > l.g + heuristic(id)) continue;
+        ++expansions;
+        const Node& n = nodes[id];
+        const GoalLink& link = goalLinks[id];
+        if (n.arriving && n.cluster == goalCluster && link.stamp == generation) {
+            relax(goal, id, link.moves, link.turns);
+        }
+        for (const Edge& e : n.edges) relax(e.to, id, e.moves, e.turns);
+    }
+    if (labels[goal].stamp != generation) return false;
+    lastMoves = labels[goal].moves;
+    lastTurns = labels[goal].turns;
+
+    route.clear();
+    for (int id = labels[goal].parent; id != start; id = labels[id].parent) route.push_back(id);
+    std::reverse(route.begin(), route.end());
+
+    // The start search is still in local. Each leaving node is followed by
+    // the arriving node across its border, one forward move away.
+    if (route.empty()) {
+        appendSteps(bestArrival(tx, ty), out);
+        return true;
+    }
+    appendSteps(toLocal(nodes[route[0]].state), out);
+    out.push_back(0);
+    if (!wholePath) return true;
+    for (size_t i = 1; i < route.size(); i += 2) {
+        const Node& in = nodes[route[i]];
+        loadCluster(in.cluster);
+        searchFrom(toLocal(in.state));
+        if (i + 1 == route.size()) {
+            appendSteps(bestArrival(tx, ty), out);
+        } else {
+            appendSteps(toLocal(nodes[route[i + 1]].state), out);
+            out.push_back(0);
+        }
+    }
+    return true;
+}
+
+size_t HierarchicalPlanner::memoryBytes() const {
+    size_t bytes = sizeof(*this) + blocked.capacity() +
+                   clusters.capacity() * sizeof(Cluster) +
+                   (eastBorders.capacity() + southBorders.capacity()) * sizeof(Border) +
+                   nodes.capacity() * sizeof(Node) + freeNodes.capacity() * sizeof(int32_t) +
+                   labels.capacity() * sizeof(Label) + goalLinks.capacity() * sizeof(GoalLink) +
+                   open.memoryBytes() + box.memoryBytes() - sizeof(box) + local.memoryBytes() +
+                   steps.capacity() + route.capacity() * sizeof(int32_t);
+    for (const Cluster& c : clusters) {
+        bytes += (c.arriving.capacity() + c.leaving.capacity()) * sizeof(int32_t);
+    }
+    for (const Border& b : eastBorders) bytes += b.nodes.capacity() * sizeof(int32_t);
+    for (const Border& b : southBorders) bytes += b.nodes.capacity() * sizeof(int32_t);
+    for (const Node& n : nodes) bytes += n.edges.capacity() * sizeof(Edge);
+    return bytes;
+}
@@ -0,0 +1,173 @@
+// HierarchicalPlanner.h
+#ifndef HIERARCHICAL_PLANNER_H
+#define HIERARCHICAL_PLANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "GridMap.h"
+#include "GridSearch.h"
+
+// HPA* over (x, y, yaw) states. The map is cut into square clusters, and
+// every run of free cell pairs across a cluster border gets one or two
+// transitions. A transition adds two abstract nodes on each side: the
+// state that leaves the cluster across it and the state that arrives
+// through it. Inside a cluster every arriving node is linked to every
+// leaving one at the cost of a search confined to the cluster.
+//
+// A query searches the grid only inside the start and goal clusters, then
+// the small abstract graph in between, and refines just the first leg into
+// commands. Paths may cost a little more than a flat search's, since they
+// can only cross borders at transitions. Changing a cell rebuilds only its
+// own cluster, plus the neighbour across a border the cell lies on.
+class HierarchicalPlanner {
+public:
+    static const int CLUSTER_SIZE = 16;
+
+    HierarchicalPlanner(PlanCost moveCost, PlanCost rotationCost, int width, int height);
+
+    // Change the edge weights; every cluster is rebuilt on the next plan()
+    void setCosts(PlanCost moveCost, PlanCost rotationCost);
+
+    // Change the map dimensions; clears every cell and cluster
+    void resize(int width, int height);
+
+    // Report the obstacle status of a cell. A change marks the clusters it
+    // touches for rebuilding on the next plan().
+    void setObstacle(int x, int y, bool obstacle);
+
+    // Plan from the given pose to cell (tx,ty), arriving in any heading.
+    // Commands, one byte each (0 = forward, otherwise the +90/-90 turn),
+    // are appended to out up to and including the first border crossing,
+    // or all the way with wholePath. Returns false if the cell is
+    // unreachable.
+    bool plan(int sx, int sy, int syaw, int tx, int ty, std::vector<int8_t>& out,
+              bool wholePath = false);
+
+    // Forward moves and turns of the whole path found by the last
+    // successful plan(), refined or not
+    int getLastMoves() const { return lastMoves; }
+    int getLastTurns() const { return lastTurns; }
+
+    // Grid states, rebuilt clusters' included, plus abstract nodes
+    // expanded by the last plan()
+    int getLastExpansions() const { return expansions; }
+
+    // Clusters the last plan() had to rebuild first
+    int getLastRebuilt() const { return rebuilt; }
+
+    // Approximate heap plus object size
+    size_t memoryBytes() const;
+
+private:
+    // Runs of free cell pairs at least this long get a transition at each
+    // end instead of one in the middle
+    static const int SPLIT_RUN = 6;
+
+    struct Edge {
+        int32_t to;
+        int16_t moves;
+        int16_t turns;
+    };
+    struct Node {
+        int32_t state;      // grid state, cell * 4 + heading
+        int32_t cluster;    // -1 once freed
+        bool arriving;      // just crossed into cluster, else about to leave it
+        // Arriving: every leaving node of the cluster it can reach.
+        // Leaving: the arriving node across the border.
+        std::vector<Edge> edges;
+    };
+    struct Cluster {
+        std::vector<int32_t> arriving;
+        std::vector<int32_t> leaving;
+        bool dirty = true;
+    };
+    // Transitions to the east or south neighbour of a cluster
+    struct Border {
+        std::vector<int32_t> nodes;
+        bool dirty = true;
+    };
+    // Abstract search label per node, valid while stamp is current
+    struct Label {
+        PlanCost g;
+        int32_t parent;
+        int32_t moves;
+        int32_t turns;
+        uint32_t stamp;
+    };
+    // Path from an arriving node of the goal cluster to the goal
+    struct GoalLink {
+        int16_t moves;
+        int16_t turns;
+        uint32_t stamp;
+    };
+
+    int stateIndex(int x, int y, int h) const { return (y * width + x) * NUM_HEADINGS + h; }
+    int clusterOf(int x, int y) const {
+        return (y / CLUSTER_SIZE) * clustersX + x / CLUSTER_SIZE;
+    }
+    PlanCost pathCost(int moves, int turns) const {
+        return moves * moveCost + turns * rotationCost;
+    }
+
+    void markCell(int x, int y);
+    // Rebuild every dirty border, then every dirty cluster
+    void repair();
+    void rebuildBorder(int c, bool east);
+    void rebuildCluster(int c);
+    void addTransition(Border& border, int ax, int ay, int bx, int by, int heading);
+    int allocNode(int state, int cluster, bool arriving);
+    void freeNode(int id);
+
+    // Copy cluster c into box, with cells outside the map blocked
+    void loadCluster(int c);
+    // Grid state to state in box of the loaded cluster
+    int toLocal(int state) const;
+    // Search box from one state over every state it reaches
+    void searchFrom(int state);
+    // Cheapest local state at cell (x,y) after searchFrom(), or -1
+    int bestArrival(int x, int y) const;
+    // Moves and turns from a searched local state back to its seed
+    void countSteps(int local, int& moves, int& turns) const;
+    // Append the commands from the seed of searchFrom() to local
+    void appendSteps(int local, std::vector<int8_t>& out);
+
+    PlanCost moveCost;
+    PlanCost rotationCost;
+
+    int width;
+    int height;
+    int clustersX;
+    int clustersY;
+
+    std::vector<uint8_t> blocked;   // row-major, 1 = obstacle
+    std::vector<Cluster> clusters;
+    std::vector<Border> eastBorders;    // per cluster
+    std::vector<Border> southBorders;
+    bool anyDirty;
+
+    std::vector<Node> nodes;
+    std::vector<int32_t> freeNodes;
+
+    // Abstract A*; labels has two extra slots past the nodes, the goal and
+    // the start
+    std::vector<Label> labels;
+    std::vector<GoalLink> goalLinks;
+    uint32_t generation;
+    BinaryHeap<PlanCost> open;
+
+    // One cluster's cells and search state, reused for every grid search
+    GridMap box;
+    int originX;
+    int originY;
+    SearchWorkspace<PlanCost> local;
+    std::vector<int8_t> steps;      // scratch for appendSteps()
+    std::vector<int32_t> route;     // abstract nodes of the last path
+
+    int lastMoves;
+    int lastTurns;
+    int expansions;
+    int rebuilt;
+};
+
+#endif  // HIERARCHICAL_PLANNER_H
@@ -0,0 +1,220 @@
+// IncrementalPlanner.cpp
+#include "IncrementalPlanner.h"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
+IncrementalPlanner::IncrementalPlanner(PlanCost moveCost, PlanCost rotationCost, int width, int height)
+    : moveCost(moveCost),
+      rotationCost(rotationCost),
+      width(0),
+      height(0),
+      numStates(0),
+      queueCapacity(0),
+      initialized(false),
+      start(0),
+      lastStart(0),
+      km(0),
+      expansions(0) {
+    resize(width, height);
+}
+
+void IncrementalPlanner::reset() {
+    initialized = false;
+}
+
+void IncrementalPlanner::setCosts(PlanCost newMoveCost, PlanCost newRotationCost) {
+    moveCost = newMoveCost;
+    rotationCost = newRotationCost;
+    reset();
+}
+
+void IncrementalPlanner::resize(int w, int h) {
+    width = w;
+    height = h;
+    numStates = w * h * NUM_HEADINGS;
+    queueCapacity = numStates * 2;
+    cells.assign(static_cast<size_t>(w) * h, 0);
+    g.assign(numStates, UNREACHABLE);
+    rhs.assign(numStates, UNREACHABLE);
+    queue.clear();
+    initialized = false;
+}
+
+void IncrementalPlanner::setCell(int x, int y, bool obstacle, bool isGoal) {
+    if (!inBounds(x, y)) return;
+    uint8_t& c = cells[y * width + x];
+    if (((c & BLOCKED) != 0) != obstacle) c ^= BLOCKED | PENDING_OBSTACLE;
+    if (((c & GOAL) != 0) != isGoal) c ^= GOAL | PENDING_GOAL;
+}
+
+int IncrementalPlanner::getLastExpansions() const {
+    return expansions;
+}
+
+size_t IncrementalPlanner::memoryBytes() const {
+    return sizeof(*this) + cells.capacity() +
+           (g.capacity() + rhs.capacity()) * sizeof(PlanCost) +
+           queue.capacity() * sizeof(QueueEntry);
+}
+
+// Manhattan distance from the robot, ignoring heading; consistent because a
+// rotation never changes it and a forward move changes it by one cell.
+PlanCost IncrementalPlanner::heuristic(int s) const {
+    return (std::abs(stateX(s) - stateX(start)) + std::abs(stateY(s) - stateY(start))) * moveCost;
+}
+
+IncrementalPlanner::Key IncrementalPlanner::calculateKey(int s) const {
+    PlanCost m = std::min(g[s], rhs[s]);
+    if (m == UNREACHABLE) return {UNREACHABLE, UNREACHABLE};
+    return {m + heuristic(s) + km, m};
+}
+
+bool IncrementalPlanner::isGoalState(int s) const {
+    return (cells[s / NUM_HEADINGS] & GOAL) != 0;
+}
+
+// Cheapest c(s, s') + g(s') over the successors of s
+PlanCost IncrementalPlanner::minSuccessor(int s, int* next, int8_t* turn) const {
+    int x = stateX(s);
+    int y = stateY(s);
+    int h = s % NUM_HEADINGS;
+    PlanCost best = UNREACHABLE;
+    int nx = x + HEADING_DX[h], ny = y + HEADING_DY[h];
+    if (inBounds(nx, ny) && !(cells[ny * width + nx] & BLOCKED)) {
+        int ns = stateIndex(nx, ny, h * 90);
+        if (g[ns] != UNREACHABLE && moveCost + g[ns] < best) {
+            best = moveCost + g[ns];
+            if (next) { *next = ns; *turn = 0; }
+        }
+    }
+    const int8_t turns[2] = {-90, 90};
+    for (int8_t t : turns) {
+        int ns = stateIndex(x, y, (h * 90 + 360 + t) % 360);
+        if (g[ns] != UNREACHABLE && rotationCost + g[ns] < best) {
+            best = rotationCost + g[ns];
+            if (next) { *next = ns; *turn = t; }
+        }
+    }
+    return best;
+}
+
+void IncrementalPlanner::updateVertex(int s) {
+    if (!isGoalState(s)) rhs[s] = minSuccessor(s, nullptr, nullptr);
+    else rhs[s] = 0;
+    if (g[s] != rhs[s]) push(s);
+}
+
+// Re-evaluate every state whose outgoing edges or goal status depend on (x,y)
+void IncrementalPlanner::updateCell(int x, int y, bool obstacleChanged) {
+    for (int h = 0; h < NUM_HEADINGS; ++h) {
+        updateVertex(stateIndex(x, y, h * 90));
+        if (!obstacleChanged) continue;
+        // Forward edges that enter (x,y)
+        int px = x - HEADING_DX[h], py = y - HEADING_DY[h];
+        if (inBounds(px, py))
+            updateVertex(stateIndex(px, py, h * 90));
+    }
+}
+
+void IncrementalPlanner::push(int s) {
+    if (static_cast<int>(queue.size()) >= queueCapacity) compact();
+    queue.push_back({calculateKey(s), static_cast<int32_t>(s)});
+    std::push_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+}
+
+// Rebuild the queue with one fresh entry per inconsistent state
+void IncrementalPlanner::compact() {
+    queue.clear();
+    for (int s = 0; s < numStates; ++s) {
+        if (g[s] != rhs[s]) queue.push_back({calculateKey(s), static_cast<int32_t>(s)});
+    }
+    std::make_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+}
+
+void IncrementalPlanner::initialize(int s) {
+    std::fill(g.begin(), g.end(), UNREACHABLE);
+    std::fill(rhs.begin(), rhs.end(), UNREACHABLE);
+    for (uint8_t& c : cells) c &= BLOCKED | GOAL;
+    queue.clear();
+    km = 0;
+    start = lastStart = s;
+    for (int i = 0; i < numStates; ++i) {
+        if (isGoalState(i)) {
+            rhs[i] = 0;
+            push(i);
+        }
+    }
+    initialized = true;
+}
+
+void IncrementalPlanner::computeShortestPath() {
+    while (!queue.empty() &&
+           (queue[0].key < calculateKey(start) || rhs[start] != g[start])) {
+        std::pop_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+        QueueEntry top = queue.back();
+        queue.pop_back();
+        int u = top.state;
+        // Stale duplicate of a state that has since become consistent
+        if (g[u] == rhs[u]) continue;
+        Key fresh = calculateKey(u);
+        if (top.key < fresh) {
+            push(u);
+            continue;
+        }
+        ++expansions;
+        int x = stateX(u);
+        int y = stateY(u);
+        int h = u % NUM_HEADINGS;
+        if (g[u] > rhs[u]) {
+            g[u] = rhs[u];
+        } else {
+            g[u] = UNREACHABLE;
+            updateVertex(u);
+        }
+        // Predecessors: the two rotations into this heading and the forward
+        // move from the cell behind, if this cell may be entered at all
+        updateVertex(stateIndex(x, y, (h * 90 + 90) % 360));
+        updateVertex(stateIndex(x, y, (h * 90 + 270) % 360));
+        int px = x - HEADING_DX[h], py = y - HEADING_DY[h];
+        if (!(cells[y * width + x] & BLOCKED) && inBounds(px, py))
+            updateVertex(stateIndex(px, py, h * 90));
+    }
+}
+
+bool IncrementalPlanner::plan(int sx, int sy, int syaw, MotionPlan& out) {
+    expansions = 0;
+    int s = stateIndex(sx, sy, syaw);
+    if (initialized) {
+        start = s;
+        km += heuristic(lastStart);
+        if (km > KM_LIMIT) initialized = false;
+    }
+    if (!initialized) {
+        initialize(s);
+    } else {
+        lastStart = s;
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                uint8_t& c = cells[y * width + x];
+                if (!(c & (PENDING_OBSTACLE | PENDING_GOAL))) continue;
+                updateCell(x, y, (c & PENDING_OBSTACLE) != 0);
+                c &= BLOCKED | GOAL;
+            }
+        }
+    }
+    computeShortestPath();
+    if (rhs[start] == UNREACHABLE) return false;
+
+    // Follow the cheapest successor down to a goal
+    out.clear();
+    int cur = start;
+    for (int steps = 0; !isGoalState(cur) && steps < numStates; ++steps) {
+        int next = -1;
+        int8_t turn = 0;
+        if (minSuccessor(cur, &next, &turn) == UNREACHABLE) break;
+        out.push(turn);
+        cur = next;
+    }
+    return true;
+}
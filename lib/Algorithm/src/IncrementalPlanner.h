@@ -0,0 +1,111 @@
+// IncrementalPlanner.h
+#ifndef INCREMENTAL_PLANNER_H
+#define INCREMENTAL_PLANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "GridSearch.h"
+#include "MotionPlan.h"
+
+// D* Lite over (x, y, yaw) states. The search runs backwards from the goal
+// cells, so the tree survives robot motion and is only repaired around cells
+// whose obstacle or goal bit changed since the previous plan. Costs are
+// integer PlanCost units, so nothing in the search needs the FPU.
+class IncrementalPlanner {
+public:
+    IncrementalPlanner(PlanCost moveCost, PlanCost rotationCost, int width, int height);
+
+    // Drop the search tree; the next plan() starts from scratch
+    void reset();
+
+    // Change the edge weights; drops the search tree
+    void setCosts(PlanCost moveCost, PlanCost rotationCost);
+
+    // Change the map dimensions; clears every cell and the search tree
+    void resize(int width, int height);
+
+    // Report the current obstacle/goal status of a cell. Changes are queued
+    // and repaired on the next plan().
+    void setCell(int x, int y, bool obstacle, bool goal);
+
+    // Plan from the given pose to the nearest goal cell. Leaves out untouched
+    // and returns false if no goal is reachable.
+    bool plan(int sx, int sy, int syaw, MotionPlan& out);
+
+    // Number of states expanded by the last plan()
+    int getLastExpansions() const;
+
+    // Approximate heap plus object size
+    size_t memoryBytes() const;
+
+private:
+    // Per-cell flag bits
+    static const uint8_t BLOCKED = 1;
+    static const uint8_t GOAL = 2;
+    static const uint8_t PENDING_OBSTACLE = 4;   // changed since the last plan
+    static const uint8_t PENDING_GOAL = 8;
+
+    struct Key {
+        PlanCost k1, k2;
+        bool operator<(const Key& o) const {
+            return k1 < o.k1 || (k1 == o.k1 && k2 < o.k2);
+        }
+    };
+    struct QueueEntry {
+        Key key;
+        int32_t state;
+        bool operator>(const QueueEntry& o) const { return o.key < key; }
+    };
+
+    // Row-major over cells, headings innermost
+    int stateIndex(int x, int y, int yaw) const {
+        return (y * width + x) * NUM_HEADINGS + yaw / 90;
+    }
+    int stateX(int s) const { return (s / NUM_HEADINGS) % width; }
+    int stateY(int s) const { return (s / NUM_HEADINGS) / width; }
+    bool inBounds(int x, int y) const {
+        return x >= 0 && x < width && y >= 0 && y < height;
+    }
+
+    // g, rhs and key values of states no path reaches
+    static constexpr PlanCost UNREACHABLE = unreachableCost<PlanCost>();
+    // km only grows; the tree is rebuilt before it could push keys past
+    // what fits in a PlanCost
+    static constexpr PlanCost KM_LIMIT = UNREACHABLE / 4;
+
+    PlanCost heuristic(int s) const;
+    Key calculateKey(int s) const;
+    bool isGoalState(int s) const;
+    PlanCost minSuccessor(int s, int* next, int8_t* turn) const;
+    void updateVertex(int s);
+    void updateCell(int x, int y, bool obstacleChanged);
+    void computeShortestPath();
+    void initialize(int start);
+    void push(int s);
+    void compact();
+
+    PlanCost moveCost;
+    PlanCost rotationCost;
+
+    int width;
+    int height;
+    int numStates;
+    // Lazy deletion leaves stale entries behind; the queue is compacted
+    // back to at most numStates entries once it reaches twice that.
+    int queueCapacity;
+
+    std::vector<uint8_t> cells;   // row-major flag bits
+    bool initialized;
+
+    std::vector<PlanCost> g;
+    std::vector<PlanCost> rhs;
+    std::vector<QueueEntry> queue;  // binary heap; capacity kept across plans
+
+    int start;
+    int lastStart;
+    PlanCost km;
+    int expansions;
+};
+
+#endif  // INCREMENTAL_PLANNER_H
@@ -0,0 +1,218 @@
+// JumpSearch.h
+#ifndef JUMP_SEARCH_H
+#define JUMP_SEARCH_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include "GridSearch.h"
+
+// Jump point search over the same (x, y, heading) states as searchStates(),
+// adapted to a 4-connected grid with turn costs. A forward move runs
+// straight on and only stops at a cell where turning can matter:
+//   - a goal cell
+//   - the last free cell before an obstacle or the map edge
+//   - a cell whose left or right neighbour differs from that of the cell
+//     before or after it, i.e. a corner starts or ends beside the run
+//   - a cell from which a straight look to either side reaches a goal or
+//     such a corner on the crossing line
+// Turns are only expanded at those jump points, so a run over open floor
+// is one state instead of one per cell, at moveCost per cell crossed. Two
+// linked states with the same heading are joined by the straight run
+// between their cells.
+
+namespace jump_detail {
+
+inline bool isFree(const GridMap& map, int x, int y) { return !map.isObstacle(x, y); }
+
+// Does a neighbour on either side of (x,y) differ from the one beside the
+// previous or next cell along heading h? Only free cells on the line count.
+inline bool sideChanges(const GridMap& map, int x, int y, int h) {
+    int dx = HEADING_DX[h], dy = HEADING_DY[h];
+    bool back = isFree(map, x - dx, y - dy), ahead = isFree(map, x + dx, y + dy);
+    // Sides are perpendicular to h: (-dy, dx) and (dy, -dx)
+    for (int side = -1; side <= 1; side += 2) {
+        int sx = -dy * side, sy = dx * side;
+        bool here = isFree(map, x + sx, y + sy);
+        if ((back && here != isFree(map, x - dx + sx, y - dy + sy)) ||
+            (ahead && here != isFree(map, x + dx + sx, y + dy + sy))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 0 for headings along x, 1 along y
+inline int axisOf(int h) { return HEADING_DX[h] != 0 ? 0 : 1; }
+
+}  // namespace jump_detail
+
+// The free straight segments of a map along each axis, and whether a run
+// along that axis would stop for a corner anywhere on them. Built once per
+// obstacle layout, so testing the crossing line at a cell is a lookup
+// instead of a scan. Whether a segment holds a goal depends on the search
+// and is worked out on first ask, once per segment and search.
+class JumpLines {
+public:
+    void build(const GridMap& map) {
+        width = map.width();
+        int cells = map.cellCount();
+        corner.assign(cells, 0);
+        for (int axis = 0; axis < 2; ++axis) {
+            Axis& a = axes[axis];
+            a.segmentOf.assign(cells, -1);
+            a.start.clear();
+            a.length.clear();
+            a.hasCorner.clear();
+            // Either heading along the axis; sideChanges() looks both ways
+            int h = axis == 0 ? 1 : 0;
+            int lines = axis == 0 ? map.height() : map.width();
+            int along = axis == 0 ? map.width() : map.height();
+            for (int line = 0; line < lines; ++line) {
+                int seg = -1;
+                for (int i = 0; i < along; ++i) {
+                    int x = axis == 0 ? i : line, y = axis == 0 ? line : i;
+                    if (!jump_detail::isFree(map, x, y)) {
+                        seg = -1;
+                        continue;
+                    }
+                    int cell = map.index(x, y);
+                    if (seg < 0) {
+                        seg = static_cast<int>(a.start.size());
+                        a.start.push_back(cell);
+                        a.length.push_back(0);
+                        a.hasCorner.push_back(0);
+                    }
+                    a.segmentOf[cell] = seg;
+                    ++a.length[seg];
+                    if (jump_detail::sideChanges(map, x, y, h)) {
+                        corner[cell] |= uint8_t(1 << axis);
+                        a.hasCorner[seg] = 1;
+                    }
+                }
+            }
+            a.goalStamp.assign(a.start.size(), 0);
+            a.hasGoal.assign(a.start.size(), 0);
+        }
+        stamp = 0;
+    }
+
+    bool empty() const { return corner.empty(); }
+
+    // Forget the goal flags of the previous search
+    void newSearch() {
+        if (++stamp != 0) return;
+        for (Axis& a : axes) std::fill(a.goalStamp.begin(), a.goalStamp.end(), 0);
+        stamp = 1;
+    }
+
+    // Would a run along h be worth stopping at (x,y)? Yes at a goal or a
+    // corner, or if the crossing segment through (x,y) holds either.
+    template <typename Policy>
+    bool isJumpPoint(const Policy& policy, int x, int y, int h) {
+        int cell = y * width + x;
+        int axis = jump_detail::axisOf(h);
+        if (policy.isGoal(x, y) || (corner[cell] >> axis & 1)) return true;
+        Axis& cross = axes[1 - axis];
+        int seg = cross.segmentOf[cell];
+        if (cross.hasCorner[seg]) return true;
+        if (cross.goalStamp[seg] != stamp) {
+            cross.goalStamp[seg] = stamp;
+            cross.hasGoal[seg] = segmentHasGoal(policy, 1 - axis, seg);
+        }
+        return cross.hasGoal[seg];
+    }
+
+    size_t memoryBytes() const {
+        size_t bytes = corner.capacity();
+        for (const Axis& a : axes) {
+            bytes += a.segmentOf.capacity() * sizeof(int32_t) +
+                     (a.start.capacity() + a.length.capacity()) * sizeof(int32_t) +
+                     a.hasCorner.capacity() + a.goalStamp.capacity() * sizeof(uint32_t) +
+                     a.hasGoal.capacity();
+        }
+        return bytes;
+    }
+
+private:
+    struct Axis {
+        std::vector<int32_t> segmentOf;    // per cell, -1 on obstacles
+        std::vector<int32_t> start;        // per segment: first cell
+        std::vector<int32_t> length;
+        std::vector<uint8_t> hasCorner;
+        std::vector<uint32_t> goalStamp;   // search hasGoal was worked out for
+        std::vector<uint8_t> hasGoal;
+    };
+
+    template <typename Policy>
+    bool segmentHasGoal(const Policy& policy, int axis, int seg) const {
+        const Axis& a = axes[axis];
+        int x = a.start[seg] % width, y = a.start[seg] / width;
+        for (int i = 0; i < a.length[seg]; ++i) {
+            if (axis == 0 ? policy.isGoal(x + i, y) : policy.isGoal(x, y + i)) return true;
+        }
+        return false;
+    }
+
+    int width = 0;
+    std::vector<uint8_t> corner;    // bit per axis: sideChanges() along it
+    Axis axes[2];
+    uint32_t stamp = 0;
+};
+
+// Same contract as searchStates(), forward searches only, with lines built
+// for the current obstacles of map. Cells passed over by a jump are not
+// stamped in ws; walk the parents and fill in the runs.
+template <typename Cost, typename Queue, typename Policy>
+int jumpSearchStates(SearchWorkspace<Cost, Queue>& ws, JumpLines& lines, const GridMap& map,
+                     const Policy& policy, Cost moveCost, Cost rotateCost) {
+    static_assert(!Policy::REVERSE, "jump point search runs forwards only");
+    lines.newSearch();
+    const int width = map.width();
+    auto improve = [&](int s, Cost c, int from, int8_t cmd, Cost h) {
+        if (c < ws.costOf(s)) {
+            ws.relax(s, c, from, cmd);
+            ws.push(c + h, s);
+        }
+    };
+    while (!ws.empty()) {
+        QueueEntry<Cost> top = ws.pop();
+        int s = top.state;
+        int cell = s / NUM_HEADINGS;
+        int h = s % NUM_HEADINGS;
+        int x = cell % width;
+        int y = cell / width;
+        Cost g = ws.cost[s];
+        Cost hHere = policy.heuristic(x, y);
+        if (top.priority > g + hHere) continue;
+        if (policy.isGoal(x, y)) return s;
+
+        int dx = HEADING_DX[h], dy = HEADING_DY[h];
+        int nx = x, ny = y, run = 0;
+        while (jump_detail::isFree(map, nx + dx, ny + dy)) {
+            nx += dx;
+            ny += dy;
+            ++run;
+            if (!jump_detail::isFree(map, nx + dx, ny + dy) ||
+                lines.isJumpPoint(policy, nx, ny, h)) {
+                break;
+            }
+        }
+        if (run > 0) {
+            improve(map.index(nx, ny) * NUM_HEADINGS + h, g + moveCost * run, s, 0,
+                    policy.heuristic(nx, ny));
+        }
+        improve(cell * NUM_HEADINGS + (h + NUM_HEADINGS - 1) % NUM_HEADINGS,
+                g + rotateCost, s, -90, hHere);
+        improve(cell * NUM_HEADINGS + (h + 1) % NUM_HEADINGS,
+                g + rotateCost, s, 90, hHere);
+    }
+    return -1;
+}
+
+// Forward moves between the cells of two states linked by a jump
+inline int jumpLength(int fromCell, int toCell, int width) {
+    return std::abs(fromCell % width - toCell % width) + std::abs(fromCell / width - toCell / width);
+}
+
+#endif  // JUMP_SEARCH_H
@@ -0,0 +1,54 @@
+// MotionPlan.h
+#ifndef MOTION_PLAN_H
+#define MOTION_PLAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A run of identical steps: count cells straight on, or count 90° turns
+// the same way (2 = a 180° turn)
+struct MotionPrimitive {
+    enum Op : uint8_t { FORWARD, TURN_LEFT, TURN_RIGHT };
+    Op op;
+    uint16_t count;
+};
+
+// A planned path, run-length coded into motion primitives and kept in one
+// contiguous buffer. A straight corridor is a single entry however long it
+// is, and the buffer keeps its storage across clear(), so replanning stops
+// allocating once it has grown to the longest plan so far.
+class MotionPlan {
+public:
+    void clear() { primitives.clear(); }
+    // Room for n primitives before the buffer grows
+    void reserve(size_t n) { primitives.reserve(n); }
+    bool empty() const { return primitives.empty(); }
+    size_t size() const { return primitives.size(); }
+    const MotionPrimitive& front() const { return primitives.front(); }
+    const MotionPrimitive& operator[](size_t i) const { return primitives[i]; }
+    std::vector<MotionPrimitive>::const_iterator begin() const { return primitives.begin(); }
+    std::vector<MotionPrimitive>::const_iterator end() const { return primitives.end(); }
+
+    // Append one step: 0 = forward, otherwise the +90/-90 turn. It joins
+    // the last primitive if that is the same kind of step.
+    void push(int8_t turn) {
+        MotionPrimitive::Op op = turn == 0 ? MotionPrimitive::FORWARD
+                                 : turn < 0 ? MotionPrimitive::TURN_LEFT
+                                            : MotionPrimitive::TURN_RIGHT;
+        if (!primitives.empty() && primitives.back().op == op &&
+            primitives.back().count < UINT16_MAX) {
+            ++primitives.back().count;
+        } else {
+            primitives.push_back({op, 1});
+        }
+    }
+
+    // Heap size of the primitives
+    size_t memoryBytes() const { return primitives.capacity() * sizeof(MotionPrimitive); }
+
+private:
+    std::vector<MotionPrimitive> primitives;
+};
+
+#endif  // MOTION_PLAN_H
@@ -0,0 +1,57 @@
+// PathCache.cpp
+#include "PathCache.h"
+
+PathCache::PathCache(size_t capacity)
+    : entries(capacity),
+      slotLength(0),
+      tick(0) {}
+
+void PathCache::resize(size_t newSlotLength, size_t longestPath) {
+    slotLength = newSlotLength;
+    slots.assign(entries.size() * slotLength, 0);
+    spill.assign(longestPath, 0);
+    clear();
+}
+
+bool PathCache::find(const PathKey& key, PathView& path) {
+    for (size_t i = 0; i < entries.size(); ++i) {
+        Entry& e = entries[i];
+        if (e.lastUsed != 0 && e.key == key) {
+            e.lastUsed = ++tick;
+            ++counters.hits;
+            const int8_t* first = slots.data() + i * slotLength;
+            path = {first, first + e.length};
+            return true;
+        }
+    }
+    ++counters.misses;
+    return false;
+}
+
+int8_t* PathCache::claim(const PathKey& key, size_t length) {
+    size_t victim = 0;
+    for (size_t i = 1; i < entries.size(); ++i) {
+        if (entries[i].lastUsed < entries[victim].lastUsed) victim = i;
+    }
+    Entry& e = entries[victim];
+    if (e.lastUsed != 0) ++counters.evictions;
+    e.key = key;
+    e.lastUsed = ++tick;
+    e.length = static_cast<uint32_t>(length);
+    return slots.data() + victim * slotLength;
+}
+
+void PathCache::clear() {
+    for (Entry& e : entries) e.lastUsed = 0;
+}
+
+size_t PathCache::size() const {
+    size_t n = 0;
+    for (const Entry& e : entries) n += e.lastUsed != 0;
+    return n;
+}
+
+size_t PathCache::memoryBytes() const {
+    return sizeof(*this) + entries.capacity() * sizeof(Entry) + slots.capacity() +
+           spill.capacity();
+}
@@ -0,0 +1,95 @@
+// PathCache.h
+#ifndef PATH_CACHE_H
+#define PATH_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Where a cached path starts and ends, how it was planned, and the house
+// obstacle version it was planned against. Entries of older versions are
+// never hit again and age out of the cache.
+struct PathKey {
+    int16_t x, y, yaw;
+    int16_t goalX, goalY;
+    uint8_t method;     // planner's own tag; paths of different searches differ
+    uint32_t obstacleVersion;
+
+    bool operator==(const PathKey& o) const {
+        return x == o.x && y == o.y && yaw == o.yaw && goalX == o.goalX &&
+               goalY == o.goalY && method == o.method && obstacleVersion == o.obstacleVersion;
+    }
+};
+
+struct PathCacheStats {
+    unsigned long hits = 0;
+    unsigned long misses = 0;
+    unsigned long evictions = 0;
+};
+
+// Commands of a cached path, valid until the next insert() or resize()
+struct PathView {
+    const int8_t* first;
+    const int8_t* last;
+    const int8_t* begin() const { return first; }
+    const int8_t* end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+};
+
+// Small least-recently-used cache of planned command sequences, one byte
+// per command: 0 = forward, otherwise the +90/-90 turn. Lookups scan every
+// slot, which is cheaper than hashing at these sizes. All slots share one
+// buffer sized by resize(), so the cache never allocates while planning.
+class PathCache {
+public:
+    explicit PathCache(size_t capacity);
+
+    // Size every slot for paths of up to slotLength commands, and the spill
+    // buffer for the longest path that will be inserted. Forgets every entry.
+    void resize(size_t slotLength, size_t longestPath);
+
+    // Commands cached for key into path, or false; a hit makes the entry
+    // the most recently used
+    bool find(const PathKey& key, PathView& path);
+
+    // Store [first, last) of MovementCommands under key, replacing the least
+    // recently used entry once every slot is taken. A path too long for a
+    // slot is not cached but still returned, from the spill buffer.
+    template <typename It>
+    PathView insert(const PathKey& key, It first, It last) {
+        size_t length = static_cast<size_t>(last - first);
+        int8_t* out = length <= slotLength ? claim(key, length) : spill.data();
+        for (int8_t* o = out; first != last; ++first) {
+            *o++ = static_cast<int8_t>(first->isMove ? 0 : first->angle);
+        }
+        return {out, out + length};
+    }
+
+    // Forget every entry, e.g. when the planner weights change
+    void clear();
+
+    size_t size() const;
+    const PathCacheStats& stats() const { return counters; }
+
+    // Heap plus object size
+    size_t memoryBytes() const;
+
+private:
+    struct Entry {
+        PathKey key;
+        uint32_t lastUsed = 0;   // 0 = empty slot
+        uint32_t length = 0;
+    };
+
+    // Empty slot (or evicted LRU slot) now owned by key, for length commands
+    int8_t* claim(const PathKey& key, size_t length);
+
+    std::vector<Entry> entries;
+    std::vector<int8_t> slots;  // slotLength commands per entry
+    std::vector<int8_t> spill;
+    size_t slotLength;
+    uint32_t tick;
+    PathCacheStats counters;
+};
+
+#endif  // PATH_CACHE_H
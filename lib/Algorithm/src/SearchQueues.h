@@ -0,0 +1,165 @@
+// SearchQueues.h
+#ifndef SEARCH_QUEUES_H
+#define SEARCH_QUEUES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Min-priority queues for searchStates(). resize() is called with the
+// workspace, for the number of states and the largest priority rise per
+// edge; after that clear() keeps the storage, so a search does not allocate
+// once the queue has reached its high-water mark.
+
+template <typename Cost>
+struct QueueEntry {
+    Cost priority;
+    int32_t state;
+};
+
+// Binary min-heap; works for any cost type. Hand-rolled so the child pick
+// is a select rather than a hard-to-predict branch.
+template <typename Cost>
+class BinaryHeap {
+public:
+    void push(Cost priority, int s) {
+        size_t i = heap.size();
+        heap.push_back({priority, static_cast<int32_t>(s)});
+        QueueEntry<Cost> e = heap[i];
+        while (i > 0) {
+            size_t p = (i - 1) / 2;
+            if (!(heap[p].priority > e.priority)) break;
+            heap[i] = heap[p];
+            i = p;
+        }
+        heap[i] = e;
+    }
+
+    QueueEntry<Cost> pop() {
+        QueueEntry<Cost> top = heap.front();
+        QueueEntry<Cost> last = heap.back();
+        heap.pop_back();
+        size_t n = heap.size();
+        if (n == 0) return top;
+        size_t i = 0;
+        for (;;) {
+            size_t c = 2 * i + 1;
+            if (c >= n) break;
+            if (c + 1 < n) c += heap[c + 1].priority < heap[c].priority;
+            if (!(heap[c].priority < last.priority)) break;
+            heap[i] = heap[c];
+            i = c;
+        }
+        heap[i] = last;
+        return top;
+    }
+
+    bool empty() const { return heap.empty(); }
+    // A heap holds any priorities; it grows to its high-water mark
+    void resize(int, Cost) { heap.clear(); }
+    void clear() { heap.clear(); }
+    size_t memoryBytes() const { return heap.capacity() * sizeof(QueueEntry<Cost>); }
+
+private:
+    std::vector<QueueEntry<Cost>> heap;
+};
+
+// Dial's bucket queue for non-negative integer priorities. Only valid for
+// monotone searches: nothing may be pushed below the last popped priority,
+// and every queued priority lies within maxRise above it. Dijkstra and A*
+// with a consistent heuristic satisfy both, with maxRise the largest edge
+// weight plus the largest heuristic change per edge.
+//
+// The ring has one bucket per priority in that window and is sized once by
+// resize(). Buckets are lists threaded through per-state links, so a state
+// is queued at most once: pushing it again moves it to its new priority.
+// Push is O(1) and pop a scan to the next non-empty bucket; entries of
+// equal priority come out first in, first out.
+template <typename Cost>
+class BucketQueue {
+public:
+    void resize(int numStates, Cost maxRise) {
+        size_t size = 16;
+        while (size <= static_cast<size_t>(maxRise)) size *= 2;
+        heads.assign(size, EMPTY);
+        tails.assign(size, EMPTY);
+        mask = size - 1;
+        next.assign(numStates, IDLE);
+        prev.assign(numStates, EMPTY);
+        count = 0;
+    }
+
+    void push(Cost priority, int s) {
+        if (next[s] != IDLE) unlink(s);
+        // Below cursor is fine down to the last popped priority, e.g. a
+        // turn queued after the forward move out of the same state
+        if (count == 0 || priority < cursor) cursor = priority;
+        size_t b = static_cast<size_t>(priority) & mask;
+        next[s] = endOf(b);
+        if (tails[b] == EMPTY) {
+            prev[s] = endOf(b);
+            heads[b] = s;
+        } else {
+            prev[s] = tails[b];
+            next[tails[b]] = s;
+        }
+        tails[b] = s;
+        ++count;
+    }
+
+    QueueEntry<Cost> pop() {
+        while (heads[static_cast<size_t>(cursor) & mask] == EMPTY) ++cursor;
+        int32_t s = heads[static_cast<size_t>(cursor) & mask];
+        unlink(s);
+        return {cursor, s};
+    }
+
+    bool empty() const { return count == 0; }
+
+    void clear() {
+        if (count == 0) return;
+        for (size_t b = 0; b < heads.size(); ++b) {
+            for (int32_t s = heads[b]; s >= 0;) {
+                int32_t after = next[s];
+                next[s] = IDLE;
+                s = after;
+            }
+            heads[b] = tails[b] = EMPTY;
+        }
+        count = 0;
+    }
+
+    size_t memoryBytes() const {
+        return (heads.capacity() + tails.capacity() + next.capacity() + prev.capacity()) *
+               sizeof(int32_t);
+    }
+
+private:
+    static constexpr int32_t EMPTY = -1;       // heads[] and tails[] of an empty bucket
+    static constexpr int32_t IDLE = INT32_MIN; // next[] of a state not queued
+
+    // The links before a bucket's first state and after its last one name
+    // the bucket, so a state can be unlinked without knowing its priority
+    static int32_t endOf(size_t b) { return -1 - static_cast<int32_t>(b); }
+    static size_t bucketOf(int32_t end) { return static_cast<size_t>(-1 - end); }
+
+    void unlink(int32_t s) {
+        int32_t before = prev[s], after = next[s];
+        if (before >= 0) next[before] = after;
+        else heads[bucketOf(before)] = after >= 0 ? after : EMPTY;
+        if (after >= 0) prev[after] = before;
+        else tails[bucketOf(after)] = before >= 0 ? before : EMPTY;
+        next[s] = IDLE;
+        --count;
+    }
+
+    std::vector<int32_t> heads;   // first and last state per bucket
+    std::vector<int32_t> tails;
+    std::vector<int32_t> next;    // per state, along its bucket
+    std::vector<int32_t> prev;
+    size_t mask = 0;
+    Cost cursor = 0;    // lowest priority that may still be queued
+    size_t count = 0;
+};
+
+#endif  // SEARCH_QUEUES_H
@@ -20,8 +20,15 @@
 
 #define BAT_DRAIN_MOVE          0.5f
 #define BAT_DRAIN_ROTATE        0.25f
+#define BAT_DRAIN_CLEAN         1.0f
+#define BAT_DRAIN_CLEAN_HEAVY   2.0f   // dirt above BAT_DRAIN_CLEAN_THRESH
 #define BAT_DRAIN_CLEAN_THRESH  5
 #define BAT_LOW_THRESHOLD      25.0f
+#define BAT_HOME_MARGIN         5.0f   // spare charge on top of the trip home
+
+// Planner edge weights; only their ratio changes which path wins
+#define PLAN_COST_MOVE          2.0f
+#define PLAN_COST_ROTATE        1.5f
 
 #define BAT_DRAIN_BG_INTERVAL 10000u
 #define BAT_DRAIN_BG_AMOUNT   0.1f
@@ -31,4 +38,11 @@
 #define CELL_SIZE      12
 #define HEADER_HEIGHT  50
 
+// Values picked by `program --tune` override the defaults above
+#if defined(__has_include)
+#if __has_include("TunedConstants.h")
+#include "TunedConstants.h"
+#endif
+#endif
+
 #endif // CONSTANTS_H
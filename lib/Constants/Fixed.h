@@ -0,0 +1,64 @@
+// Signed Q-format fixed point in 32 bits. The ESP32-C3 has no FPU, so the
+// battery model uses this instead of float: constants are converted at
+// compile time, and adding, subtracting and comparing are a few integer
+// instructions instead of soft-float library calls. Sums and products
+// saturate at min()/max() rather than wrap.
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <cstdint>
+
+template <int FRAC_BITS>
+class Fixed {
+public:
+    static constexpr int32_t ONE = int32_t(1) << FRAC_BITS;
+
+    constexpr Fixed() : value(0) {}
+    // Rounded to the nearest step. Meant for constants and host tools; at
+    // run time on the target this is a soft-float conversion.
+    constexpr explicit Fixed(double v)
+        : value(static_cast<int32_t>(v * ONE + (v < 0 ? -0.5 : 0.5))) {}
+
+    static constexpr Fixed fromRaw(int32_t raw) {
+        Fixed f;
+        f.value = raw;
+        return f;
+    }
+    // Largest value, used as "no limit" or "unreachable"
+    static constexpr Fixed max() { return fromRaw(INT32_MAX); }
+    static constexpr Fixed min() { return fromRaw(INT32_MIN); }
+
+    constexpr int32_t raw() const { return value; }
+    constexpr float toFloat() const { return static_cast<float>(value) / ONE; }
+    // Rounded to whole tenths, for display
+    constexpr int tenths() const {
+        return static_cast<int>((int64_t(value) * 10 + ONE / 2) >> FRAC_BITS);
+    }
+
+    constexpr Fixed operator+(Fixed o) const { return saturate(int64_t(value) + o.value); }
+    constexpr Fixed operator-(Fixed o) const { return saturate(int64_t(value) - o.value); }
+    constexpr Fixed operator*(int n) const { return saturate(int64_t(value) * n); }
+    Fixed& operator+=(Fixed o) { return *this = *this + o; }
+    Fixed& operator-=(Fixed o) { return *this = *this - o; }
+
+    constexpr bool operator==(Fixed o) const { return value == o.value; }
+    constexpr bool operator!=(Fixed o) const { return value != o.value; }
+    constexpr bool operator<(Fixed o) const { return value < o.value; }
+    constexpr bool operator<=(Fixed o) const { return value <= o.value; }
+    constexpr bool operator>(Fixed o) const { return value > o.value; }
+    constexpr bool operator>=(Fixed o) const { return value >= o.value; }
+
+private:
+    // Clamp a widened result; wrapping int32_t would be undefined behaviour
+    static constexpr Fixed saturate(int64_t v) {
+        return fromRaw(v > INT32_MAX ? INT32_MAX : v < INT32_MIN ? INT32_MIN : int32_t(v));
+    }
+
+    int32_t value;
+};
+
+// Battery charge and drains in percent of a full battery, Q16.16: steps of
+// 1/65536 % and a range far beyond the 0..100 the robot uses
+typedef Fixed<16> Battery;
+
+#endif // FIXED_H
@@ -0,0 +1,39 @@
+// Runtime copy of the battery and planner constants, so host tools can try
+// other values per run. Defaults come from Constants.h; charges and drains
+// are fixed point, see Fixed.h.
+#ifndef ROBOT_CONFIG_H
+#define ROBOT_CONFIG_H
+
+#include "Constants.h"
+#include "Fixed.h"
+
+// Battery drain and duration of each robot action
+struct MotionCosts {
+    Battery moveDrain = Battery(BAT_DRAIN_MOVE);
+    Battery rotateDrain = Battery(BAT_DRAIN_ROTATE);
+    Battery cleanDrain = Battery(BAT_DRAIN_CLEAN);             // dirt level <= heavyDirtLevel
+    Battery heavyCleanDrain = Battery(BAT_DRAIN_CLEAN_HEAVY);  // dirt level above it
+    int heavyDirtLevel = BAT_DRAIN_CLEAN_THRESH;
+    unsigned long moveMs = MOVE_DELAY;
+    unsigned long rotateMs = ROTATE_DELAY;
+    unsigned long cleanMs = CLEAN_DELAY;
+
+    Battery cleanDrainFor(int dirt) const {
+        return dirt <= heavyDirtLevel ? cleanDrain : heavyCleanDrain;
+    }
+};
+
+// Edge weights of the path searches
+struct PlannerWeights {
+    float move = PLAN_COST_MOVE;
+    float rotate = PLAN_COST_ROTATE;
+};
+
+struct RobotConfig {
+    MotionCosts motion;
+    PlannerWeights planner;
+    Battery lowThreshold = Battery(BAT_LOW_THRESHOLD);  // head home here if home is walled off
+    Battery homeMargin = Battery(BAT_HOME_MARGIN);      // spare charge on top of the trip home
+};
+
+#endif // ROBOT_CONFIG_H
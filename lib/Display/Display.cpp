@@ -1,8 +1,66 @@
 #include "Display.h"
 #include <Arduino.h>
+#include <string.h>
 
 Adafruit_ILI9341 tft(TFT_CS, TFT_DC, TFT_RST);
 
+// ── Retained frame ──────────────────────────────────────────────────────
+// What each view cell showed after the last drawGrid(): dirt level 0..7,
+// CELL_OBSTACLE, CELL_OUTSIDE (past the map edge) or, for the robot,
+// CELL_ROBOT*(1+heading) + what it stands on. CELL_UNKNOWN forces a repaint.
+static const uint8_t CELL_OBSTACLE = 8;
+static const uint8_t CELL_OUTSIDE  = 9;
+static const uint8_t CELL_ROBOT    = 16;
+static const uint8_t CELL_UNKNOWN  = 0xFF;
+static uint8_t shownCell[VIEW_CELLS][VIEW_CELLS];
+
+// Map cell shown in the top-left corner. The view only scrolls once the
+// robot gets within VIEW_MARGIN cells of its edge.
+static const int VIEW_MARGIN = 2;
+static int viewX = 0, viewY = 0;
+
+static bool  hudValid = false;
+static bool  shownAuto = false, shownRtb = false;
+static int   shownBatTenths = -1;
+
+// ── Counters ────────────────────────────────────────────────────────────
+// SPI traffic is estimated from the ILI9341 protocol: every window write
+// sends CASET/RASET/RAMWR (11 bytes) followed by 2 bytes per pixel.
+static const uint32_t WINDOW_OVERHEAD = 11;
+static DisplayStats lastFrame = {0, 0, 0};
+static DisplayStats building  = {0, 0, 0};
+
+static void countRect(int w, int h) {
+  building.spiBytes += WINDOW_OVERHEAD + uint32_t(w) * h * 2;
+  building.writes++;
+}
+
+// Text is drawn glyph by glyph: 6x8 pixels per character, scaled
+static void countText(int chars, int size) {
+  for (int i = 0; i < chars; i++) countRect(6*size, 8*size);
+}
+
+static void fillRectCounted(int x, int y, int w, int h, uint16_t c) {
+  tft.fillRect(x, y, w, h, c);
+  countRect(w, h);
+}
+
+// Dirt level -> colour, built once from the original shading formula
+static uint16_t dirtLut[MAX_DIRT+1];
+
+static void buildDirtLut() {
+  for (int d = 0; d <= MAX_DIRT; d++) {
+    uint8_t r = constrain(255 - d*15, 101,255),
+            g = constrain(255 - d*23,  67,255),
+            b = constrain(255 - d*30,  33,255);
+    dirtLut[d] = tft.color565(r,g,b);
+  }
+}
+
+const DisplayStats& getDisplayStats() {
+  return lastFrame;
+}
+
 void setupDisplay() {
   tft.begin();
   tft.setRotation(0);
@@ -11,59 +69,230 @@ void setupDisplay() {
   tft.setTextSize(2);
   tft.setCursor(5,5);   tft.print("Mode:");
   tft.setCursor(5,25);  tft.print("Batt:");
+  buildDirtLut();
+  memset(shownCell, CELL_UNKNOWN, sizeof(shownCell));
+  hudValid = false;
 }
 
-void updateHUD(bool returningHome, bool autoMode, float batteryLevel) {
-  tft.fillRect(90,5,100,20,ILI9341_BLACK);
-  tft.setCursor(90,5);
-  tft.print(autoMode ? "AUTO" : "MANUAL");
-  tft.fillRect(90,25,60,20,ILI9341_BLACK);
-  tft.setCursor(90,25);
-  tft.printf("%.1f%%", batteryLevel);
-  if (returningHome) {
-    tft.setCursor(160,5);
-    tft.setTextColor(ILI9341_YELLOW);
-    tft.print("RTB");
-    tft.setTextColor(ILI9341_WHITE);
+void updateHUD(bool returningHome, bool autoMode, Battery batteryLevel) {
+  unsigned long t0 = micros();
+  int batTenths = batteryLevel.tenths();
+  // "MANUAL" runs into the RTB field, so repainting the mode repaints both
+  bool modeChanged = !hudValid || autoMode != shownAuto;
+  if (modeChanged) {
+    fillRectCounted(90,5,72,20,ILI9341_BLACK);
+    tft.setCursor(90,5);
+    tft.print(autoMode ? "AUTO" : "MANUAL");
+    countText(autoMode ? 4 : 6, 2);
+    shownAuto = autoMode;
+  }
+  if (!hudValid || batTenths != shownBatTenths) {
+    fillRectCounted(90,25,90,20,ILI9341_BLACK);
+    tft.setCursor(90,25);
+    tft.printf("%d.%d%%", batTenths / 10, batTenths % 10);
+    countText(batTenths >= 1000 ? 6 : batTenths >= 100 ? 5 : 4, 2);
+    shownBatTenths = batTenths;
+  }
+  if (modeChanged || returningHome != shownRtb) {
+    fillRectCounted(160,5,40,20,ILI9341_BLACK);
+    if (returningHome) {
+      tft.setCursor(160,5);
+      tft.setTextColor(ILI9341_YELLOW);
+      tft.print("RTB");
+      tft.setTextColor(ILI9341_WHITE);
+      countText(3, 2);
+    }
+    shownRtb = returningHome;
   }
+  hudValid = true;
+  building.frameUs += micros() - t0;
 }
 
-static void drawRobot(int px, int py, int cs, int robotDir) {
-  int cx = px + cs/2, cy = py + cs/2;
-  tft.fillCircle(cx, cy, cs/2, ILI9341_RED);
+// Heading marker (8x6 black box with a 4x2 white slot), relative to the cell
+static void robotMarker(int cs, int robotDir, int &mx, int &my) {
   int ox=0, oy=0;
   if (robotDir==0) oy=-1;
   else if (robotDir==1) ox=1;
   else if (robotDir==2) oy=1;
   else if (robotDir==3) ox=-1;
   int w=8, h=6;
-  int mx = cx+ox*(cs/2-h/2)-w/2,
-      my = cy+oy*(cs/2-h/2)-h/2;
-  tft.fillRect(mx, my, w, h, ILI9341_BLACK);
-  tft.fillRect(mx+2, my+2, 4, 2, ILI9341_WHITE);
+  mx = cs/2+ox*(cs/2-h/2)-w/2;
+  my = cs/2+oy*(cs/2-h/2)-h/2;
+}
+
+// The robot as rectangles relative to its cell: the vertical spans of
+// Adafruit_GFX::fillCircle, then the heading marker. Everything is clipped
+// to the cell, so the sprite never spills into a neighbour and both
+// renderers put the same pixels on screen.
+template <typename Fill>
+static void robotSprite(int robotDir, Fill fill) {
+  const int cs = CELL_SIZE, r = cs/2;
+  auto rect = [&](int x, int y, int w, int h, uint16_t c) {
+    int x0 = max(x, 0), y0 = max(y, 0), x1 = min(x+w, cs), y1 = min(y+h, cs);
+    if (x0 < x1 && y0 < y1) fill(x0, y0, x1-x0, y1-y0, c);
+  };
+  const int x0 = r, y0 = r;
+  rect(x0, y0 - r, 1, 2*r + 1, ILI9341_RED);
+  int f = 1 - r, ddF_x = 1, ddF_y = -2*r, x = 0, y = r, px = x, py = y;
+  while (x < y) {
+    if (f >= 0) { y--; ddF_y += 2; f += ddF_y; }
+    x++; ddF_x += 2; f += ddF_x;
+    if (x < y + 1) {
+      rect(x0 + x, y0 - y, 1, 2*y + 1, ILI9341_RED);
+      rect(x0 - x, y0 - y, 1, 2*y + 1, ILI9341_RED);
+    }
+    if (y != py) {
+      rect(x0 + py, y0 - px, 1, 2*px + 1, ILI9341_RED);
+      rect(x0 - py, y0 - px, 1, 2*px + 1, ILI9341_RED);
+      py = y;
+    }
+    px = x;
+  }
+  int mx, my;
+  robotMarker(cs, robotDir, mx, my);
+  rect(mx, my, 8, 6, ILI9341_BLACK);
+  rect(mx+2, my+2, 4, 2, ILI9341_WHITE);
 }
 
+static void drawRobot(int px, int py, int robotDir) {
+  robotSprite(robotDir, [&](int x, int y, int w, int h, uint16_t c) {
+    fillRectCounted(px+x, py+y, w, h, c);
+  });
+}
+
+static uint16_t cellColor(uint8_t state) {
+  if (state == CELL_OBSTACLE) return ILI9341_BLUE;
+  if (state == CELL_OUTSIDE)  return ILI9341_BLACK;
+  return dirtLut[state <= MAX_DIRT ? state : MAX_DIRT];
+}
+
+// ── Tiled mode ──────────────────────────────────────────────────────────
+// One grid row of pixels (240x12 RGB565, 5.6 KB) is composed in RAM and
+// sent as a single window write.
+static const int ROW_W = VIEW_CELLS*CELL_SIZE;
+static uint16_t rowBuf[ROW_W*CELL_SIZE];
+static bool tiled = false;
+
+void setTiledRendering(bool enabled) {
+  tiled = enabled;
+  memset(shownCell, CELL_UNKNOWN, sizeof(shownCell));
+}
+
+// Fill within the cell starting at column `left` of the row buffer
+static void bufFillRect(uint16_t *buf, int stride, int left,
+                        int x, int y, int w, int h, uint16_t c) {
+  for (int j = max(y, 0); j < min(y+h, CELL_SIZE); j++)
+    for (int i = max(x, left); i < min(x+w, left+CELL_SIZE); i++)
+      buf[j*stride + i] = c;
+}
+
+static void bufRobot(uint16_t *buf, int stride, int left, int robotDir) {
+  robotSprite(robotDir, [&](int x, int y, int w, int h, uint16_t c) {
+    bufFillRect(buf, stride, left, left+x, y, w, h, c);
+  });
+}
+
+static void drawRowTiled(int py, int first, int last,
+                         const uint8_t state[VIEW_CELLS], uint8_t under, int robotDir) {
+  int w = (last-first+1)*CELL_SIZE;
+  for (int x = first; x <= last; x++) {
+    int left = (x-first)*CELL_SIZE;
+    bool robot = state[x] >= CELL_ROBOT;
+    bufFillRect(rowBuf, w, left, left, 0, CELL_SIZE, CELL_SIZE,
+                cellColor(robot ? under : state[x]));
+    if (robot) bufRobot(rowBuf, w, left, robotDir);
+  }
+  tft.startWrite();
+  tft.setAddrWindow(first*CELL_SIZE, py, w, CELL_SIZE);
+  tft.writePixels(rowBuf, uint32_t(w)*CELL_SIZE);
+  tft.endWrite();
+  countRect(w, CELL_SIZE);
+}
+
+// Within a row, adjacent changed cells of the same colour go out as one
+// fillRect.
+static void drawRowCells(int py, const uint8_t state[VIEW_CELLS],
+                         const bool changed[VIEW_CELLS], uint8_t under, int robotDir) {
+  int runStart = -1;
+  for (int x = 0; x <= VIEW_CELLS; x++) {
+    // Close the pending run when it can't be extended by this cell
+    if (runStart >= 0 && (x == VIEW_CELLS || !changed[x] || state[x] != state[runStart])) {
+      fillRectCounted(runStart*CELL_SIZE, py, (x-runStart)*CELL_SIZE, CELL_SIZE,
+                      cellColor(state[runStart]));
+      runStart = -1;
+    }
+    if (x == VIEW_CELLS || !changed[x]) continue;
+    if (state[x] >= CELL_ROBOT) {
+      // Clear the previous heading marker before drawing the robot
+      fillRectCounted(x*CELL_SIZE, py, CELL_SIZE, CELL_SIZE, cellColor(under));
+      drawRobot(x*CELL_SIZE, py, robotDir);
+    } else if (runStart < 0) {
+      runStart = x;
+    }
+  }
+}
+
+// Scroll one axis so the robot stays at least VIEW_MARGIN cells inside
+static int followRobot(int origin, int robot, int mapSize) {
+  if (mapSize <= VIEW_CELLS) return 0;
+  if (robot < origin + VIEW_MARGIN || robot >= origin + VIEW_CELLS - VIEW_MARGIN)
+    origin = robot - VIEW_CELLS/2;
+  return constrain(origin, 0, mapSize - VIEW_CELLS);
+}
+
+bool screenToCell(int screenX, int screenY, int &x, int &y) {
+  if (screenX < 0 || screenY < HEADER_HEIGHT) return false;
+  int vx = screenX / CELL_SIZE, vy = (screenY - HEADER_HEIGHT) / CELL_SIZE;
+  if (vx >= VIEW_CELLS || vy >= VIEW_CELLS) return false;
+  x = viewX + vx;
+  y = viewY + vy;
+  return true;
+}
+
+// Repaints only cells whose state changed since the last call, either
+// cell by cell or, in tiled mode, as one composed span per row. Maps larger
+// than the view show the VIEW_CELLS x VIEW_CELLS window around the robot.
 void drawGrid(int robotX, int robotY,
-              const int dirtGrid[GRID_SIZE][GRID_SIZE],
-              const bool obstacleGrid[GRID_SIZE][GRID_SIZE],
+              const Grid &grid,
               int robotDir)
 {
-  for (int y = 0; y < GRID_SIZE; y++) {
-    for (int x = 0; x < GRID_SIZE; x++) {
-      int px = x*CELL_SIZE;
-      int py = y*CELL_SIZE + HEADER_HEIGHT;
-      if (x==robotX && y==robotY) {
-        drawRobot(px, py, CELL_SIZE, robotDir);
-      } else if (obstacleGrid[y][x]) {
-        tft.fillRect(px, py, CELL_SIZE, CELL_SIZE, ILI9341_BLUE);
-      } else {
-        int d = dirtGrid[y][x];
-        uint8_t r = constrain(255 - d*15, 101,255),
-                g = constrain(255 - d*23,  67,255),
-                b = constrain(255 - d*30,  33,255);
-        tft.fillRect(px, py, CELL_SIZE, CELL_SIZE,
-                     tft.color565(r,g,b));
+  unsigned long t0 = micros();
+  int nvx = followRobot(viewX, robotX, grid.width());
+  int nvy = followRobot(viewY, robotY, grid.height());
+  if (nvx != viewX || nvy != viewY) {
+    viewX = nvx;
+    viewY = nvy;
+    memset(shownCell, CELL_UNKNOWN, sizeof(shownCell));
+  }
+  int rx = robotX - viewX, ry = robotY - viewY;
+  // What the robot is standing on, shown around it
+  uint8_t under = 0;
+  if (grid.inBounds(robotX, robotY))
+    under = grid.isObstacle(robotX, robotY) ? CELL_OBSTACLE : uint8_t(grid.dirtAt(robotX, robotY));
+  for (int y = 0; y < VIEW_CELLS; y++) {
+    int py = y*CELL_SIZE + HEADER_HEIGHT;
+    int my = viewY + y;
+    uint8_t state[VIEW_CELLS];
+    bool changed[VIEW_CELLS];
+    int first = -1, last = -1;
+    for (int x = 0; x < VIEW_CELLS; x++) {
+      int mx = viewX + x;
+      if (x==rx && y==ry)                  state[x] = CELL_ROBOT*(1+robotDir) + under;
+      else if (!grid.inBounds(mx, my))      state[x] = CELL_OUTSIDE;
+      else if (grid.isObstacle(mx, my))   state[x] = CELL_OBSTACLE;
+      else                                 state[x] = uint8_t(grid.dirtAt(mx, my));
+      changed[x] = state[x] != shownCell[y][x];
+      shownCell[y][x] = state[x];
+      if (changed[x]) {
+        if (first < 0) first = x;
+        last = x;
       }
     }
+    if (first < 0) continue;
+    if (tiled) drawRowTiled(py, first, last, state, under, robotDir);
+    else       drawRowCells(py, state, changed, under, robotDir);
   }
+  building.frameUs += micros() - t0;
+  lastFrame = building;
+  building = {0, 0, 0};
 }
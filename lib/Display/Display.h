@@ -4,15 +4,35 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_ILI9341.h>
 #include "Constants.h"
+#include "Fixed.h"
+#include "Grid.h"
 
 // The one-and-only TFT instance
 extern Adafruit_ILI9341 tft;
 
+// Cells shown per row and column; larger maps scroll to follow the robot
+static const int VIEW_CELLS = GRID_SIZE;
+
+// Cost of the last frame (updateHUD + drawGrid)
+struct DisplayStats {
+  uint32_t spiBytes;   // estimated bytes sent over SPI
+  uint32_t frameUs;    // time spent drawing
+  uint16_t writes;     // window writes issued
+};
+
 void setupDisplay();
-void updateHUD(bool returningHome, bool autoMode, float batteryLevel);
+// Both redraw only what changed since the previous frame
+void updateHUD(bool returningHome, bool autoMode, Battery batteryLevel);
 void drawGrid(int robotX, int robotY,
-              const int dirtGrid[GRID_SIZE][GRID_SIZE],
-              const bool obstacleGrid[GRID_SIZE][GRID_SIZE],
+              const Grid &grid,
               int robotDir);
+const DisplayStats& getDisplayStats();
+
+// Map cell under a screen pixel in the current view; false outside the grid
+bool screenToCell(int screenX, int screenY, int &x, int &y);
+
+// Compose each changed row span in a RAM line buffer and push it with one
+// bulk write instead of per-cell fillRects. Forces a full repaint.
+void setTiledRendering(bool enabled);
 
 #endif // DISPLAY_H
@@ -1,37 +1,62 @@
 #include "Grid.h"
 
-int dirtGrid[GRID_SIZE][GRID_SIZE];
-bool obstacleGrid[GRID_SIZE][GRID_SIZE];
-unsigned long lastCleanTime[GRID_SIZE][GRID_SIZE];
-static unsigned long lastDirtGrow = 0;
+Grid::Grid(int width, int height)
+  : map(width, height),
+    lastCleanTime(map.cellCount(), millis()) {
+  freeCells.setFree(map);
+}
 
-void setupGrid() {
+void Grid::setup(int width, int height) {
   randomSeed(analogRead(0));
+  map.resize(width, height);
+  lastCleanTime.assign(map.cellCount(), 0);
+  freeCells.setFree(map);
+  obstacleRev++;
   unsigned long now = millis();
-  for(int y=0;y<GRID_SIZE;y++){
-    for(int x=0;x<GRID_SIZE;x++){
+  for(int y=0;y<map.height();y++){
+    for(int x=0;x<map.width();x++){
       int init = random(0, MAX_DIRT+1);
-      dirtGrid[y][x]      = init;
-      lastCleanTime[y][x] = now - init*DIRT_ACCUM_INTERVAL;
-      obstacleGrid[y][x]  = false;
+      lastCleanTime[map.index(x,y)] = now - init*DIRT_ACCUM_INTERVAL;
     }
   }
 }
 
-void updateDirtLevels() {
+int Grid::dirtAt(int x,int y) const {
+  int base = map.dirtAt(x,y);
+  if (map.isObstacleAt(x,y)) return base;
   unsigned long now = millis();
-  if (now - lastDirtGrow < DIRT_ACCUM_INTERVAL) return;
-  lastDirtGrow = now;
-  for(int y=0;y<GRID_SIZE;y++){
-    for(int x=0;x<GRID_SIZE;x++){
-      if (!obstacleGrid[y][x] && dirtGrid[y][x] < MAX_DIRT)
-        dirtGrid[y][x]++;
-    }
+  unsigned long &cleaned = lastCleanTime[map.index(x,y)];
+  int d = base + int((now - cleaned) / DIRT_ACCUM_INTERVAL);
+  if (d >= MAX_DIRT) {
+    // Pin saturated cells to now so the elapsed time can't wrap millis()
+    map.setDirtAt(x,y,MAX_DIRT);
+    cleaned = now;
+    return MAX_DIRT;
   }
+  return d;
+}
+
+void Grid::setDirt(int x,int y,int level) {
+  map.setDirtAt(x,y,level);
+  lastCleanTime[map.index(x,y)] = millis();
+}
+
+void Grid::toggleObstacle(int x,int y) {
+  // Freeze (or resume) accumulation at the current level
+  setDirt(x, y, dirtAt(x, y));
+  map.setObstacleAt(x, y, !map.isObstacleAt(x, y));
+  freeCells.set(x, y, !map.isObstacleAt(x, y));
+  obstacleRev++;
+}
+
+bool Grid::canPlaceObstacle(int x,int y,int robotX,int robotY) const {
+  if (!isValid(x,y) || (x==robotX && y==robotY) || (x==0 && y==0)) return false;
+  trial = freeCells;
+  trial.set(x, y, false);
+  reach.floodFrom(trial, robotX, robotY);
+  return reach.test(0, 0);
 }
 
-bool isValid(int x,int y){
-  return x>=0 && x<GRID_SIZE &&
-         y>=0 && y<GRID_SIZE &&
-        !obstacleGrid[y][x];
+bool Grid::isValid(int x,int y) const {
+  return map.inBounds(x,y) && !map.isObstacleAt(x,y);
 }
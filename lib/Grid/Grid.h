@@ -2,14 +2,49 @@
 #define GRID_H
 
 #include "Constants.h"
+#include "BitGrid.h"
+#include "GridMap.h"
 #include <Arduino.h>
+#include <vector>
 
-extern int dirtGrid[GRID_SIZE][GRID_SIZE];
-extern bool obstacleGrid[GRID_SIZE][GRID_SIZE];
-extern unsigned long lastCleanTime[GRID_SIZE][GRID_SIZE];
+// The firmware's view of the floor: obstacles plus the dirt of every cell.
+// Dirt is evaluated lazily: a cell holds the level it had at its last clean
+// and gains one level per DIRT_ACCUM_INTERVAL of millis() since then.
+// Obstacle cells don't accumulate.
+class Grid {
+public:
+  Grid(int width = GRID_SIZE, int height = GRID_SIZE);
 
-void setupGrid();
-void updateDirtLevels();
-bool isValid(int x,int y);
+  // Resize and start every cell at a random dirt level, no obstacles
+  void setup(int width = GRID_SIZE, int height = GRID_SIZE);
 
-#endif // GRID_H
\ No newline at end of file
+  int width() const { return map.width(); }
+  int height() const { return map.height(); }
+  bool inBounds(int x,int y) const { return map.inBounds(x,y); }
+  bool isObstacle(int x,int y) const { return map.isObstacleAt(x,y); }
+  // In bounds and not blocked
+  bool isValid(int x,int y) const;
+
+  // Current dirt level of a cell, O(1) for any elapsed time
+  int dirtAt(int x,int y) const;
+  void setDirt(int x,int y,int level);
+  void toggleObstacle(int x,int y);
+  // Goes up with every obstacle change, so copies can tell when to resync
+  uint32_t obstacleVersion() const { return obstacleRev; }
+  // False if blocking free cell (x,y) would leave the robot at
+  // (robotX,robotY) with no way back to home (0,0)
+  bool canPlaceObstacle(int x,int y,int robotX,int robotY) const;
+
+private:
+  // dirtAt() pins saturated cells to now, which doesn't change any level
+  mutable GridMap map;
+  // millis() of each cell's last clean, row-major like map
+  mutable std::vector<unsigned long> lastCleanTime;
+  uint32_t obstacleRev = 1;
+  // Non-obstacle cells, kept in step with map
+  BitGrid freeCells;
+  // Scratch for canPlaceObstacle()
+  mutable BitGrid trial, reach;
+};
+
+#endif // GRID_H
@@ -0,0 +1,106 @@
+// BitGrid.cpp
+#include "BitGrid.h"
+#include "GridMap.h"
+#include <algorithm>
+
+void BitGrid::resize(int width, int height) {
+    w = width;
+    h = height;
+    wordsPerRow = (width + WORD_BITS - 1) / WORD_BITS;
+    rows.assign(static_cast<size_t>(wordsPerRow) * h, 0);
+}
+
+void BitGrid::clear() {
+    std::fill(rows.begin(), rows.end(), 0);
+}
+
+void BitGrid::setFree(const GridMap& map) {
+    resize(map.width(), map.height());
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            if (!map.isObstacleAt(x, y)) set(x, y, true);
+        }
+    }
+}
+
+bool BitGrid::any() const {
+    for (Word word : rows) {
+        if (word) return true;
+    }
+    return false;
+}
+
+int BitGrid::count() const {
+    int n = 0;
+    for (Word word : rows) n += __builtin_popcountll(word);
+    return n;
+}
+
+bool BitGrid::intersects(const BitGrid& other) const {
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (rows[i] & other.rows[i]) return true;
+    }
+    return false;
+}
+
+void BitGrid::floodFrom(const BitGrid& passable, int x, int y) {
+    resize(passable.w, passable.h);
+    if (x < 0 || x >= w || y < 0 || y >= h || !passable.test(x, y)) return;
+    set(x, y, true);
+    // Alternate downward and upward sweeps until neither adds a cell; each
+    // sweep carries the fill through any number of rows in its direction
+    bool grew = true;
+    growRow(passable, y, -1);
+    while (grew) {
+        grew = false;
+        for (int r = 1; r < h; ++r) grew |= growRow(passable, r, r - 1);
+        for (int r = h - 2; r >= 0; --r) grew |= growRow(passable, r, r + 1);
+    }
+}
+
+bool BitGrid::growRow(const BitGrid& passable, int y, int from) {
+    Word* row = &rows[y * wordsPerRow];
+    const Word* open = &passable.rows[y * wordsPerRow];
+    bool grew = false;
+    if (from >= 0) {
+        const Word* src = &rows[from * wordsPerRow];
+        for (int i = 0; i < wordsPerRow; ++i) {
+            Word add = src[i] & open[i] & ~row[i];
+            if (add) {
+                row[i] |= add;
+                grew = true;
+            }
+        }
+    }
+    // Rows are saturated sideways whenever they grow, so without new
+    // bits from the neighbour there is nothing more to spread
+    if (from >= 0 && !grew) return false;
+
+    // Spread along the passable runs of the row: an occluded Kogge-Stone
+    // fill in both directions within each word, then carry across word
+    // boundaries until no word changes
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 0; i < wordsPerRow; ++i) {
+            Word g = row[i];
+            if (i > 0 && (row[i - 1] >> (WORD_BITS - 1))) g |= open[i] & 1;
+            if (i + 1 < wordsPerRow && (row[i + 1] & 1)) g |= open[i] & (Word(1) << (WORD_BITS - 1));
+            Word up = g, pu = open[i];
+            Word down = g, pd = open[i];
+            for (int s = 1; s < WORD_BITS; s <<= 1) {
+                up |= pu & (up << s);
+                pu &= pu << s;
+                down |= pd & (down >> s);
+                pd &= pd >> s;
+            }
+            g = up | down;
+            if (g != row[i]) {
+                row[i] = g;
+                changed = true;
+                grew = true;
+            }
+        }
+    }
+    return grew;
+}
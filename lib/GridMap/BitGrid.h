@@ -0,0 +1,99 @@
+// BitGrid.h
+#ifndef BIT_GRID_H
+#define BIT_GRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class GridMap;
+
+// One bit per cell, each row packed into native machine words (64-bit on
+// the host, 32-bit on the ESP32), so set operations and flood fills work a
+// whole row segment at a time. Bit x % WORD_BITS of word x / WORD_BITS of a
+// row is cell x; bits past the width are always clear.
+class BitGrid {
+public:
+#if UINTPTR_MAX > 0xFFFFFFFFu
+    typedef uint64_t Word;
+#else
+    typedef uint32_t Word;
+#endif
+    static const int WORD_BITS = sizeof(Word) * 8;
+
+    BitGrid() : w(0), h(0), wordsPerRow(0) {}
+    BitGrid(int width, int height) : BitGrid() { resize(width, height); }
+
+    // Change the dimensions; every bit is cleared
+    void resize(int width, int height);
+    void clear();
+
+    int width() const { return w; }
+    int height() const { return h; }
+
+    // Unchecked, expect 0 <= x < width and 0 <= y < height
+    bool test(int x, int y) const {
+        return (rows[y * wordsPerRow + x / WORD_BITS] >> (x % WORD_BITS)) & 1;
+    }
+    void set(int x, int y, bool status) {
+        Word bit = Word(1) << (x % WORD_BITS);
+        Word& word = rows[y * wordsPerRow + x / WORD_BITS];
+        word = status ? (word | bit) : (word & ~bit);
+    }
+
+    // Resize to map and set every cell that is not an obstacle
+    void setFree(const GridMap& map);
+
+    bool any() const;
+    int count() const;
+    // Any cell set in both grids; the grids must have the same size
+    bool intersects(const BitGrid& other) const;
+
+    // Replace the contents with every cell 4-connected to (x, y) through
+    // cells set in passable, (x, y) included. Empty if (x, y) is not
+    // passable.
+    void floodFrom(const BitGrid& passable, int x, int y);
+
+    // Call f(x, y) for every set cell in row-major order
+    template <typename F>
+    void forEach(F f) const {
+        for (int y = 0; y < h; ++y) {
+            for (int i = 0; i < wordsPerRow; ++i) {
+                for (Word word = rows[y * wordsPerRow + i]; word; word &= word - 1) {
+                    f(i * WORD_BITS + lowestBit(word), y);
+                }
+            }
+        }
+    }
+
+    // True as soon as pred(x, y) holds for a set cell, scanning row-major
+    template <typename F>
+    bool anyOf(F pred) const {
+        for (int y = 0; y < h; ++y) {
+            for (int i = 0; i < wordsPerRow; ++i) {
+                for (Word word = rows[y * wordsPerRow + i]; word; word &= word - 1) {
+                    if (pred(i * WORD_BITS + lowestBit(word), y)) return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Heap plus object size
+    size_t memoryBytes() const { return sizeof(*this) + rows.capacity() * sizeof(Word); }
+
+private:
+    static int lowestBit(Word word) {
+        return sizeof(Word) == 8 ? __builtin_ctzll(word) : __builtin_ctz(word);
+    }
+    // Grow row y into its set neighbours in row `from` and sideways along
+    // its passable runs; true if any bit was added
+    bool growRow(const BitGrid& passable, int y, int from);
+
+    int w;
+    int h;
+    int wordsPerRow;
+    std::vector<Word> rows;
+};
+
+#endif  // BIT_GRID_H
@@ -0,0 +1,28 @@
+// GridMap.cpp
+#include "GridMap.h"
+#include <algorithm>
+
+GridMap::GridMap(int width, int height)
+    : w(0),
+      h(0) {
+    resize(width, height);
+}
+
+void GridMap::resize(int width, int height) {
+    w = std::min(std::max(width, 1), MAX_SIZE);
+    h = std::min(std::max(height, 1), MAX_SIZE);
+    cells.assign(static_cast<size_t>(w) * h, 0);
+}
+
+void GridMap::clear() {
+    std::fill(cells.begin(), cells.end(), 0);
+}
+
+void GridMap::clearVisited() {
+    for (uint8_t& c : cells) c &= ~VISITED_BIT;
+}
+
+void GridMap::setDirtAt(int x, int y, int level) {
+    uint8_t& c = cells[index(x, y)];
+    c = (c & ~DIRT_MASK) | static_cast<uint8_t>(std::min(std::max(level, 0), MAX_DIRT_LEVEL));
+}
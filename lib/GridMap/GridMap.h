@@ -0,0 +1,71 @@
+// GridMap.h
+#ifndef GRID_MAP_H
+#define GRID_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Cell map sized at runtime. Cells are stored row-major (index y * width + x),
+// one byte each:
+//   bits 0-2  dirt level 0..7
+//   bit  3    obstacle
+//   bit  4    visited (scratch flag for planners)
+// The *At() accessors skip bounds checks and expect inBounds(x, y); the
+// checked ones treat cells outside the map as clean, blocked and unvisited.
+class GridMap {
+public:
+    static const int MAX_SIZE = 512;
+    static const int MAX_DIRT_LEVEL = 7;
+
+    GridMap(int width, int height);
+
+    // Change the dimensions, clamped to 1..MAX_SIZE; every cell is cleared
+    void resize(int width, int height);
+    void clear();
+    // Reset the visited flag of every cell, leaving dirt and obstacles
+    void clearVisited();
+
+    int width() const { return w; }
+    int height() const { return h; }
+    int cellCount() const { return w * h; }
+    bool inBounds(int x, int y) const {
+        return static_cast<unsigned>(x) < static_cast<unsigned>(w) &&
+               static_cast<unsigned>(y) < static_cast<unsigned>(h);
+    }
+    int index(int x, int y) const { return y * w + x; }
+
+    // Unchecked accessors
+    int dirtAt(int x, int y) const { return cells[index(x, y)] & DIRT_MASK; }
+    bool isObstacleAt(int x, int y) const { return (cells[index(x, y)] & OBSTACLE_BIT) != 0; }
+    bool isVisitedAt(int x, int y) const { return (cells[index(x, y)] & VISITED_BIT) != 0; }
+    void setDirtAt(int x, int y, int level);
+    void setObstacleAt(int x, int y, bool status) { setBit(index(x, y), OBSTACLE_BIT, status); }
+    void setVisitedAt(int x, int y, bool status) { setBit(index(x, y), VISITED_BIT, status); }
+
+    // Bounds-checked accessors
+    int getDirt(int x, int y) const { return inBounds(x, y) ? dirtAt(x, y) : 0; }
+    bool isObstacle(int x, int y) const { return !inBounds(x, y) || isObstacleAt(x, y); }
+    bool isVisited(int x, int y) const { return inBounds(x, y) && isVisitedAt(x, y); }
+    void setDirt(int x, int y, int level) { if (inBounds(x, y)) setDirtAt(x, y, level); }
+    void setObstacle(int x, int y, bool status) { if (inBounds(x, y)) setObstacleAt(x, y, status); }
+    void setVisited(int x, int y, bool status) { if (inBounds(x, y)) setVisitedAt(x, y, status); }
+
+    // Heap plus object size
+    size_t memoryBytes() const { return sizeof(*this) + cells.capacity(); }
+
+private:
+    static const uint8_t DIRT_MASK = 0x07;
+    static const uint8_t OBSTACLE_BIT = 0x08;
+    static const uint8_t VISITED_BIT = 0x10;
+
+    void setBit(int i, uint8_t bit, bool status) {
+        cells[i] = status ? (cells[i] | bit) : (cells[i] & ~bit);
+    }
+
+    int w;
+    int h;
+    std::vector<uint8_t> cells;
+};
+
+#endif  // GRID_MAP_H
@@ -1,57 +1,97 @@
 
 // House.cpp
 #include "House.h"
-#include <cstdlib>
 #include <ctime>
 #include <algorithm>
+#include <random>
 
-// One dirt level accumulates every 10 seconds by default
-const float House::DIRT_ACCUM_RATE = 0.1f;
+House::House(int width, int height)
+    : House(width, height, static_cast<uint32_t>(std::time(nullptr))) {}
 
-House::House() {
-    std::srand(static_cast<unsigned>(std::time(nullptr)));
-    for (int i = 0; i < GRID_SIZE; ++i) {
-        for (int j = 0; j < GRID_SIZE; ++j) {
-            dirtLevel[i][j] = std::rand() % (MAX_DIRT_LEVEL + 1);
-            obstacleMap[i][j] = false;
-            dirtTimer[i][j] = 0.0f;
+House::House(int width, int height, uint32_t seed)
+    : map(width, height),
+      lastCleanMs(static_cast<size_t>(map.cellCount()), 0),
+      cellVersion(static_cast<size_t>(map.cellCount()), 0),
+      clockMs(0),
+      sinceRebaseMs(0),
+      version(1),
+      obstacleVersion(1) {
+    // A private generator, so equal seeds give equal houses on every
+    // platform and houses can be built on several threads
+    std::minstd_rand rng(seed);
+    for (int y = 0; y < map.height(); ++y) {
+        for (int x = 0; x < map.width(); ++x) {
+            map.setDirtAt(x, y, static_cast<int>(rng() % (MAX_DIRT_LEVEL + 1)));
         }
     }
 }
 
 int House::getDirtLevel(int x, int y) const {
-    if (x < 0 || x >= GRID_SIZE || y < 0 || y >= GRID_SIZE) return 0;
-    return dirtLevel[x][y];
+    if (!map.inBounds(x, y)) return 0;
+    return getDirtLevelAt(x, y, clockMs);
+}
+
+int House::getDirtLevelAt(int x, int y, uint32_t t) const {
+    uint32_t grown = (t - lastCleanMs[map.index(x, y)]) / DIRT_INTERVAL_MS;
+    if (grown >= MAX_DIRT_LEVEL) return MAX_DIRT_LEVEL;
+    return std::min(map.dirtAt(x, y) + static_cast<int>(grown), static_cast<int>(MAX_DIRT_LEVEL));
 }
 
 bool House::isObstacle(int x, int y) const {
-    if (x < 0 || x >= GRID_SIZE || y < 0 || y >= GRID_SIZE) return false;
-    return obstacleMap[x][y];
+    if (!map.inBounds(x, y)) return false;
+    return map.isObstacleAt(x, y);
 }
 
 void House::setObstacle(int x, int y, bool status) {
-    if (x < 0 || x >= GRID_SIZE || y < 0 || y >= GRID_SIZE) return;
-    obstacleMap[x][y] = status;
+    if (!map.inBounds(x, y) || map.isObstacleAt(x, y) == status) return;
+    map.setObstacleAt(x, y, status);
+    touch(map.index(x, y));
+    ++obstacleVersion;
+}
+
+void House::setDirtLevel(int x, int y, int level) {
+    if (!map.inBounds(x, y)) return;
+    int i = map.index(x, y);
+    level = std::min(std::max(level, 0), static_cast<int>(MAX_DIRT_LEVEL));
+    // Rewriting the current level at the current time changes nothing
+    if (lastCleanMs[i] == clockMs && map.dirtAt(x, y) == level) return;
+    map.setDirtAt(x, y, level);
+    lastCleanMs[i] = clockMs;
+    touch(i);
 }
 
 void House::resetDirt(int x, int y) {
-    if (x < 0 || x >= GRID_SIZE || y < 0 || y >= GRID_SIZE) return;
-    dirtLevel[x][y] = 0;
-    dirtTimer[x][y] = 0.0f;
+    setDirtLevel(x, y, 0);
 }
 
 void House::update(float deltaTime) {
-    for (int i = 0; i < GRID_SIZE; ++i) {
-        for (int j = 0; j < GRID_SIZE; ++j) {
-            dirtTimer[i][j] += deltaTime;
-            // Accumulate full levels as timer allows
-            float interval = 1.0f / DIRT_ACCUM_RATE;
-            while (dirtTimer[i][j] >= interval) {
-                dirtTimer[i][j] -= interval;
-                if (dirtLevel[i][j] < MAX_DIRT_LEVEL) {
-                    ++dirtLevel[i][j];
-                }
+    if (deltaTime <= 0.0f) return;
+    uint64_t step = static_cast<uint64_t>(deltaTime * 1000.0f + 0.5f);
+    clockMs += static_cast<uint32_t>(step);
+    sinceRebaseMs += static_cast<uint32_t>(std::min<uint64_t>(step, REBASE_INTERVAL_MS));
+    if (sinceRebaseMs >= REBASE_INTERVAL_MS) {
+        rebase(step >= REBASE_INTERVAL_MS);
+        sinceRebaseMs = 0;
+    }
+}
+
+void House::rebase(bool all) {
+    const uint32_t saturatedMs = MAX_DIRT_LEVEL * DIRT_INTERVAL_MS;
+    for (int y = 0; y < map.height(); ++y) {
+        for (int x = 0; x < map.width(); ++x) {
+            int i = map.index(x, y);
+            if (all || clockMs - lastCleanMs[i] >= saturatedMs) {
+                map.setDirtAt(x, y, MAX_DIRT_LEVEL);
+                lastCleanMs[i] = clockMs;
+                // The level is unchanged, but older times can no longer be
+                // evaluated against the new stamp
+                touch(i);
             }
         }
     }
 }
+
+size_t House::memoryBytes() const {
+    return sizeof(*this) + map.memoryBytes() - sizeof(map) +
+           (lastCleanMs.capacity() + cellVersion.capacity()) * sizeof(uint32_t);
+}
@@ -2,12 +2,20 @@
 #ifndef HOUSE_H
 #define HOUSE_H
 
-static const int GRID_SIZE = 20;
+#include <cstdint>
+#include <vector>
+#include "Constants.h"
+#include "GridMap.h"
 
 class House {
 public:
     // Initialize grid with random dirt levels and no obstacles
-    House();
+    explicit House(int width = GRID_SIZE, int height = GRID_SIZE);
+    // Same, with the dirt drawn from the given seed for reproducible runs
+    House(int width, int height, uint32_t seed);
+
+    int width() const { return map.width(); }
+    int height() const { return map.height(); }
 
     // Get current dirt level (0–MAX_DIRT_LEVEL)
     int getDirtLevel(int x, int y) const;
@@ -18,20 +26,58 @@ public:
     // Toggle or set obstacle status for a cell
     void setObstacle(int x, int y, bool status);
 
+    // Overwrite the dirt level of a cell (clamped to 0–MAX_DIRT_LEVEL)
+    void setDirtLevel(int x, int y, int level);
+
     // Reset dirt in a cell (e.g., after cleaning)
     void resetDirt(int x, int y);
 
-    // Update dirt accumulation over elapsed time (seconds)
+    // Advance the house clock (seconds); amortised O(1), dirt is derived
+    // on read
     void update(float deltaTime);
 
+    // House time in milliseconds
+    uint32_t getClockMs() const { return clockMs; }
+
+    // Dirt level of an in-bounds cell at house time t, which must not be
+    // earlier than the cell's last change
+    int getDirtLevelAt(int x, int y, uint32_t t) const;
+
+    // Change counters. The version goes up whenever a setter (or the
+    // periodic rebase) actually changes a cell; the obstacle version only
+    // when an obstacle bit flips. getCellVersion() is the version of an
+    // in-bounds cell's last change.
+    uint32_t getVersion() const { return version; }
+    uint32_t getObstacleVersion() const { return obstacleVersion; }
+    uint32_t getCellVersion(int x, int y) const { return cellVersion[map.index(x, y)]; }
+
+    // Read-only view of the packed cells. Obstacle bits are live; dirt bits
+    // hold each cell's level at its last clean, not the current level.
+    const GridMap& cells() const { return map; }
+
+    // Approximate heap plus object size
+    size_t memoryBytes() const;
+
 private:
-    int dirtLevel[GRID_SIZE][GRID_SIZE];
-    bool obstacleMap[GRID_SIZE][GRID_SIZE];
-    float dirtTimer[GRID_SIZE][GRID_SIZE];
+    // Settle saturated cells at the current time so no cell age can wrap
+    // the 32-bit clock; with all set, every cell is treated as saturated
+    void rebase(bool all);
+    void touch(int i) { cellVersion[i] = ++version; }
+
+    // Dirt bits hold the level each cell had at lastCleanMs; it grows by one
+    // level per DIRT_INTERVAL_MS of house time after that
+    GridMap map;
+    std::vector<uint32_t> lastCleanMs;
+    std::vector<uint32_t> cellVersion;
+    uint32_t clockMs;
+    uint32_t sinceRebaseMs;
+    uint32_t version;
+    uint32_t obstacleVersion;
 
-    static const int MAX_DIRT_LEVEL = 7;
-    // Dirt accumulation rate: levels per second
-    static const float DIRT_ACCUM_RATE;
+    static const int MAX_DIRT_LEVEL = GridMap::MAX_DIRT_LEVEL;
+    // Time for one level of dirt to accumulate
+    static const uint32_t DIRT_INTERVAL_MS = 10000;
+    static const uint32_t REBASE_INTERVAL_MS = 1u << 30;
 };
 
 #endif  // HOUSE_H
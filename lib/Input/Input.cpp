@@ -1,4 +1,7 @@
 #include "Input.h"
+#include "Display.h"
+#include "Grid.h"
+#include "Trace.h"
 #include <Arduino.h>
 #include <Wire.h>
 #include <Adafruit_FT6206.h>
@@ -26,19 +29,19 @@ void readJoystickEvent() {
   else if (yVal > hi) { joyEvent.active = true; joyEvent.dir = 0; }
 }
 
-void readTouchEvent(bool returningHome,
-                    bool obstacleGrid[GRID_SIZE][GRID_SIZE]) {
+void readTouchEvent(Grid &grid, bool returningHome, int robotX, int robotY) {
   if (returningHome) return;
   bool curr = touch.touched();
   if (curr && !prevTouchActive) {
     TS_Point p = touch.getPoint();
     int screenX = map(p.y, 0, 320, 0, tft.width()-1);
     int screenY = map(p.x, 0, 240, 0, tft.height()-1);
-    if (screenY >= HEADER_HEIGHT) {
-      int gx = screenX / CELL_SIZE;
-      int gy = (screenY - HEADER_HEIGHT) / CELL_SIZE;
-      if (gx>=0 && gx<GRID_SIZE && gy>=0 && gy<GRID_SIZE)
-        obstacleGrid[gy][gx] = !obstacleGrid[gy][gx];
+    int gx, gy;
+    if (screenToCell(screenX, screenY, gx, gy) && grid.inBounds(gx, gy)) {
+      if (grid.isObstacle(gx, gy) || grid.canPlaceObstacle(gx, gy, robotX, robotY))
+        grid.toggleObstacle(gx, gy);
+      else
+        TRACE_INFO(LOG_OBSTACLE_REJECTED, gx, gy);
     }
   }
   prevTouchActive = curr;
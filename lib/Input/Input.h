@@ -2,6 +2,7 @@
 #define INPUT_H
 
 #include "Constants.h"
+#include "Grid.h"
 #include <cstdint>
 
 struct JoyEvent {
@@ -12,7 +13,8 @@ extern JoyEvent joyEvent;
 
 void setupInput();
 void readJoystickEvent();
-void readTouchEvent(bool returningHome,
-                    bool obstacleGrid[GRID_SIZE][GRID_SIZE]);
+// A tap on a grid cell toggles it as an obstacle, unless the new obstacle
+// would cut the robot at (robotX,robotY) off from home
+void readTouchEvent(Grid &grid, bool returningHome, int robotX, int robotY);
 
 #endif // INPUT_H
\ No newline at end of file
@@ -1,32 +1,148 @@
 // Logger.cpp
 #include "Logger.h"
-#include <Arduino.h>    // for millis()
-#include <string>
+#include <cstdio>
+#include <cstring>
 
-Logger::Logger() {
-    logs.reserve(100);  // optional: pre-allocate for performance
+Logger eventLog;
+
+static const char BINARY_MAGIC[4] = {'R', 'L', 'O', 'G'};
+static const uint8_t BINARY_VERSION = 1;
+
+/// printf format per LogEvent; each is passed the record's three args
+static const char* const EVENT_TEXT[LOG_EVENT_COUNT] = {
+    "Log overflow - %d events dropped",
+    "Switched to AUTO",
+    "Switched to MANUAL",
+    "Background drain, battery %d.%d%%",
+    "Battery low (%d.%d%%) - heading home",
+    "Docked - recharged",
+    "rotateLeft, heading %d",
+    "rotateRight, heading %d",
+    "moveForward to (%d,%d)",
+    "Cleaned (%d,%d) lvl=%d",
+    "Obstacle at (%d,%d) rejected - would block home",
+    "Path cache: %d%% hits, %d entries, %d bytes",
+};
+
+Logger::Logger()
+    : head(0),
+      tail(0),
+      overflows(0),
+      droppedTotal(0),
+      reportedDrops(0) {}
+
+void Logger::logEvent(LogEvent event, int16_t a, int16_t b, int16_t c) {
+    uint16_t h = head.load(std::memory_order_relaxed);
+    uint16_t used = static_cast<uint16_t>(h - tail.load(std::memory_order_acquire));
+    uint32_t dropped = droppedTotal - reportedDrops;
+    // Drops are reported in order, as one record ahead of the next event
+    // that fits along with it
+    if (used + (dropped ? 2 : 1) > CAPACITY) {
+        ++droppedTotal;
+        overflows.store(droppedTotal, std::memory_order_relaxed);
+        return;
+    }
+    if (dropped) {
+        int16_t n = static_cast<int16_t>(dropped > INT16_MAX ? INT16_MAX : dropped);
+        put(h++, LOG_OVERFLOW, n, 0, 0);
+        reportedDrops = droppedTotal;
+    }
+    put(h++, event, a, b, c);
+    head.store(h, std::memory_order_release);
+}
+
+void Logger::put(uint16_t slot, LogEvent event, int16_t a, int16_t b, int16_t c) {
+    LogRecord& r = ring[slot % CAPACITY];
+    r.timeMs = millis();
+    r.event = event;
+    r.reserved = 0;
+    r.args[0] = a;
+    r.args[1] = b;
+    r.args[2] = c;
+}
+
+bool Logger::pop(LogRecord& record) {
+    uint16_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) return false;
+    record = ring[t % CAPACITY];
+    tail.store(static_cast<uint16_t>(t + 1), std::memory_order_release);
+    return true;
 }
 
-std::string Logger::getTimestamp() const {
-    unsigned long ms = millis();
-    unsigned long secs = ms / 1000;
-    unsigned long rem = ms % 1000;
+size_t Logger::format(const LogRecord& record, char* buf, size_t len) {
+    int n = snprintf(buf, len, "%lu.%03lus - ",
+                     static_cast<unsigned long>(record.timeMs / 1000),
+                     static_cast<unsigned long>(record.timeMs % 1000));
+    if (n < 0 || static_cast<size_t>(n) >= len) return n < 0 ? 0 : len - 1;
+    int m;
+    if (record.event < LOG_EVENT_COUNT) {
+        m = snprintf(buf + n, len - n, EVENT_TEXT[record.event],
+                     record.args[0], record.args[1], record.args[2]);
+    } else {
+        m = snprintf(buf + n, len - n, "Event %u (%d, %d, %d)", record.event,
+                     record.args[0], record.args[1], record.args[2]);
+    }
+    if (m < 0) return n;
+    return static_cast<size_t>(n + m) < len ? n + m : len - 1;
+}
+
+size_t Logger::drain(Print& out, size_t maxRecords) {
+    char line[64];
+    LogRecord r;
+    size_t count = 0;
+    while (count < maxRecords && pop(r)) {
+        size_t n = format(r, line, sizeof(line) - 1);
+        line[n++] = '\n';
+        out.write(reinterpret_cast<const uint8_t*>(line), n);
+        ++count;
+    }
+    return count;
+}
+
+size_t Logger::drainAvailable(Print& out) {
+    char line[64];
+    size_t count = 0;
+    for (;;) {
+        uint16_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) break;
+        size_t n = format(ring[t % CAPACITY], line, sizeof(line) - 1);
+        line[n++] = '\n';
+        int room = out.availableForWrite();
+        if (room < 0 || static_cast<size_t>(room) < n) break;
+        out.write(reinterpret_cast<const uint8_t*>(line), n);
+        tail.store(static_cast<uint16_t>(t + 1), std::memory_order_release);
+        ++count;
+    }
+    return count;
+}
+
+size_t Logger::drainBinary(Print& out, size_t maxRecords) {
+    LogRecord r;
+    size_t count = 0;
+    while (count < maxRecords && pop(r)) {
+        out.write(reinterpret_cast<const uint8_t*>(&r), sizeof(r));
+        ++count;
+    }
+    return count;
+}
 
-    // zero-pad milliseconds to three digits
-    char buf[16];
-    snprintf(buf, sizeof(buf), "%lu.%03lus", secs, rem);
-    return std::string(buf);
+void Logger::writeBinaryHeader(Print& out) {
+    uint8_t header[6];
+    memcpy(header, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header[4] = BINARY_VERSION;
+    header[5] = sizeof(LogRecord);
+    out.write(header, sizeof(header));
 }
 
-void Logger::logEvent(const std::string& event) {
-    std::string entry = getTimestamp() + " - " + event;
-    logs.push_back(entry);
+size_t Logger::pending() const {
+    return static_cast<uint16_t>(head.load(std::memory_order_acquire) -
+                                 tail.load(std::memory_order_relaxed));
 }
 
-const std::vector<std::string>& Logger::getLogs() const {
-    return logs;
+uint32_t Logger::getOverflowCount() const {
+    return overflows.load(std::memory_order_relaxed);
 }
 
 void Logger::clearLogs() {
-    logs.clear();
+    tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
 }
@@ -2,26 +2,95 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
-#include <vector>
-#include <string>
+#include <Arduino.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 
+/// Event ids; the text for each lives in Logger.cpp. New ids go at the end
+/// so older binary logs still decode.
+enum LogEvent : uint8_t {
+    LOG_OVERFLOW,           // a: events dropped just before this record
+    LOG_MODE_AUTO,
+    LOG_MODE_MANUAL,
+    LOG_BACKGROUND_DRAIN,   // a.b: battery level in percent
+    LOG_BATTERY_LOW,        // a.b: battery level in percent
+    LOG_DOCKED,
+    LOG_ROTATE_LEFT,        // a: new heading
+    LOG_ROTATE_RIGHT,       // a: new heading
+    LOG_MOVE_FORWARD,       // a, b: new cell
+    LOG_CLEANED,            // a, b: cell, c: dirt level
+    LOG_OBSTACLE_REJECTED,  // a, b: cell that would cut the robot off from home
+    LOG_PATH_CACHE,         // a: hit rate %, b: entries, c: bytes
+    LOG_EVENT_COUNT
+};
+
+/// One event as stored in the ring and in binary dumps (12 bytes,
+/// little-endian)
+struct LogRecord {
+    uint32_t timeMs;    // millis() when the event was logged
+    uint8_t event;      // LogEvent
+    uint8_t reserved;
+    int16_t args[3];    // event-specific, e.g. x, y, dirt level
+};
+static_assert(sizeof(LogRecord) == 12, "LogRecord is a wire format");
+
+/// Fixed-size ring of binary event records. logEvent() never allocates or
+/// blocks: when the ring is full the new record is dropped and counted,
+/// and a LOG_OVERFLOW record marks the gap once there is room again.
+/// Text is only produced when the ring is drained. Single producer and
+/// single consumer; the two may run in different contexts.
 class Logger {
 public:
+    static const uint16_t CAPACITY = 128;   // records, a power of two
+
     Logger();
-    /// Record an event with a timestamp (in seconds since startup)
-    void logEvent(const std::string& event);
 
-    /// Retrieve all logged entries
-    const std::vector<std::string>& getLogs() const;
+    /// Record an event stamped with millis()
+    void logEvent(LogEvent event, int16_t a = 0, int16_t b = 0, int16_t c = 0);
+
+    /// Take the oldest record; false if the ring is empty
+    bool pop(LogRecord& record);
+
+    /// Format up to maxRecords records as text lines ("12.345s - ...") to
+    /// out, e.g. Serial. Returns the number of records written.
+    size_t drain(Print& out, size_t maxRecords = CAPACITY);
 
-    /// Clear the log buffer
+    /// Like drain(), but stops before a line that out cannot take without
+    /// blocking (out.availableForWrite()); that record stays queued
+    size_t drainAvailable(Print& out);
+
+    /// Write up to maxRecords raw records to out, e.g. an SD file; the
+    /// host decoder turns them back into text. Returns the number written.
+    size_t drainBinary(Print& out, size_t maxRecords = CAPACITY);
+
+    /// Header that starts every binary dump
+    static void writeBinaryHeader(Print& out);
+
+    /// Records waiting to be drained
+    size_t pending() const;
+
+    /// Records dropped because the ring was full, since startup
+    uint32_t getOverflowCount() const;
+
+    /// Discard every pending record
     void clearLogs();
 
+    /// Text for a record, without a trailing newline; returns its length
+    static size_t format(const LogRecord& record, char* buf, size_t len);
+
 private:
-    std::vector<std::string> logs;
+    void put(uint16_t slot, LogEvent event, int16_t a, int16_t b, int16_t c);
 
-    /// Helper to get current timestamp as “seconds.milliseconds s”
-    std::string getTimestamp() const;
+    LogRecord ring[CAPACITY];
+    std::atomic<uint16_t> head;   // next slot to write, owned by the producer
+    std::atomic<uint16_t> tail;   // next slot to read, owned by the consumer
+    std::atomic<uint32_t> overflows;   // droppedTotal, readable from any side
+    uint32_t droppedTotal;             // producer-owned
+    uint32_t reportedDrops;            // producer-owned
 };
 
+/// The firmware's event log
+extern Logger eventLog;
+
 #endif // LOGGER_H
@@ -0,0 +1,37 @@
+// Trace.h
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "Logger.h"
+
+// Compile-time trace levels. Events above TRACE_LEVEL compile to nothing,
+// arguments included; the rest go to eventLog and are formatted when
+// loop() drains it. Set with -DTRACE_LEVEL=TRACE_LEVEL_INFO etc.
+#define TRACE_LEVEL_NONE   0
+#define TRACE_LEVEL_WARN   1
+#define TRACE_LEVEL_INFO   2
+#define TRACE_LEVEL_DEBUG  3
+
+#ifndef TRACE_LEVEL
+#define TRACE_LEVEL TRACE_LEVEL_DEBUG
+#endif
+
+#if TRACE_LEVEL >= TRACE_LEVEL_WARN
+#define TRACE_WARN(...)  eventLog.logEvent(__VA_ARGS__)
+#else
+#define TRACE_WARN(...)  ((void)0)
+#endif
+
+#if TRACE_LEVEL >= TRACE_LEVEL_INFO
+#define TRACE_INFO(...)  eventLog.logEvent(__VA_ARGS__)
+#else
+#define TRACE_INFO(...)  ((void)0)
+#endif
+
+#if TRACE_LEVEL >= TRACE_LEVEL_DEBUG
+#define TRACE_DEBUG(...) eventLog.logEvent(__VA_ARGS__)
+#else
+#define TRACE_DEBUG(...) ((void)0)
+#endif
+
+#endif // TRACE_H
@@ -1,34 +1,77 @@
 #include "Movement.h"
+#include "Grid.h"
+#include "Trace.h"
 #include <Arduino.h>
 #include <algorithm>
 
-void rotateLeft(float &bat,int &dir){
-  dir = (dir+3)%4;
-  bat = max(0.0f, bat - BAT_DRAIN_ROTATE);
-  Serial.println("rotateLeft");
-  delay(ROTATE_DELAY);
+static MotionCosts costs;
+
+void setMotionCosts(const MotionCosts &c){
+  costs = c;
 }
 
-void rotateRight(float &bat,int &dir){
-  dir = (dir+1)%4;
-  bat = max(0.0f, bat - BAT_DRAIN_ROTATE);
-  Serial.println("rotateRight");
-  delay(ROTATE_DELAY);
+static void drain(Battery &bat, Battery amount){
+  bat = std::max(Battery(), bat - amount);
 }
 
-void moveForward(int &x,int &y,int dir,float &bat){
+// Pose effect of one cell of a forward run. Every cell, the first one
+// included, was planned against an older map, so it is checked for
+// obstacles placed since; a dirty cell ends the run to be cleaned.
+static bool stepForward(const Grid &grid,int &x,int &y,int dir){
   static const int DX[4]={0,1,0,-1}, DY[4]={-1,0,1,0};
   int nx = x + DX[dir], ny = y + DY[dir];
-  if(nx>=0&&nx<GRID_SIZE&&ny>=0&&ny<GRID_SIZE){
-    x = nx; y = ny;
-    bat = max(0.0f, bat - BAT_DRAIN_MOVE);
-    Serial.println("moveForward");
-    delay(MOVE_DELAY);
+  if (!grid.inBounds(nx,ny) || grid.isObstacle(nx,ny)) return false;
+  x = nx; y = ny;
+  return true;
+}
+
+static bool stopsRun(const Grid &grid,int x,int y){
+  return grid.dirtAt(x,y) > 0;
+}
+
+void cleanCell(Grid &grid,int x,int y,Battery &bat){
+  int d = grid.dirtAt(x,y);
+  if (d <= 0) return;
+  drain(bat, costs.cleanDrainFor(d));
+  TRACE_INFO(LOG_CLEANED, x, y, d);
+  grid.setDirt(x,y,0);
+}
+
+// ── Motion queue ────────────────────────────────────────────────────────
+struct Motion {
+  MotionOp op;
+  uint16_t count;   // cells or turns; 1 for a clean
+  uint16_t done;    // landed so far
+};
+
+static const uint8_t QUEUE_LEN = 4;   // enough for a turn, a run and a clean
+static Motion queue[QUEUE_LEN];
+static uint8_t qHead = 0, qCount = 0;
+static unsigned long opStart = 0;     // start of the current cell or turn
+
+static unsigned long opDuration(MotionOp op){
+  switch (op) {
+    case OP_FORWARD: return costs.moveMs;
+    case OP_CLEAN:   return costs.cleanMs;
+    default:         return costs.rotateMs;
   }
 }
 
+bool motionIdle(){
+  return qCount == 0;
+}
+
+bool queueMotion(MotionOp op,uint16_t count){
+  if (count == 0) return true;
+  if (qCount == QUEUE_LEN) return false;
+  if (qCount == 0) opStart = millis();
+  queue[(qHead + qCount) % QUEUE_LEN] = {op, count, 0};
+  qCount++;
+  return true;
+}
+
 void stepTo(int tx,int ty,
-            int &x,int &y,int &dir,float &bat){
+            int x,int y,int dir){
   int desired;
   if      (tx>x) desired = 1;
   else if (tx<x) desired = 3;
@@ -36,25 +79,63 @@ void stepTo(int tx,int ty,
   else if (ty>y) desired = 2;
   else return;
   int diff = (desired - dir + 4)%4;
-  if (diff==1)       rotateRight(bat,dir);
-  else if (diff==3)  rotateLeft(bat,dir);
-  else if (diff==2){
-    rotateRight(bat,dir);
-    rotateRight(bat,dir);
+  if (diff==1)       queueMotion(OP_ROTATE_RIGHT);
+  else if (diff==3)  queueMotion(OP_ROTATE_LEFT);
+  else if (diff==2)  queueMotion(OP_ROTATE_RIGHT, 2);
+  queueMotion(OP_FORWARD);
+}
+
+// Land one cell or turn of m; false once m is over
+static bool advance(const Grid &grid,Motion &m,int &x,int &y,int &dir){
+  switch (m.op) {
+    case OP_ROTATE_LEFT:  dir = (dir+3)%4; break;
+    case OP_ROTATE_RIGHT: dir = (dir+1)%4; break;
+    case OP_FORWARD:
+      if (!stepForward(grid, x, y, dir)) return false;
+      if (stopsRun(grid, x, y)) {
+        m.done++;
+        return false;
+      }
+      break;
+    case OP_CLEAN: break;
   }
-  moveForward(x,y,dir,bat);
+  return ++m.done < m.count;
 }
 
-void cleanCell(int x,int y,
-               int grid[GRID_SIZE][GRID_SIZE],
-               float &bat,
-               unsigned long lastClean[GRID_SIZE][GRID_SIZE]){
-  int d = grid[y][x];
-  if (d <= 0) return;
-  float cost = (d <= BAT_DRAIN_CLEAN_THRESH ? 1.0f : 2.0f);
-  bat = max(0.0f, bat - cost);
-  Serial.printf("Cleaned (%d,%d) lvl=%d\n", x,y, d);
-  grid[y][x] = 0;
-  lastClean[y][x] = millis();
-  delay(CLEAN_DELAY);
+// Drain and log a finished action once, for everything it did; dir is
+// only read by the trace
+static void finish(Grid &grid,const Motion &m,int x,int y,[[maybe_unused]] int dir,
+                   Battery &bat){
+  switch (m.op) {
+    case OP_ROTATE_LEFT:
+      drain(bat, costs.rotateDrain * m.done);
+      TRACE_DEBUG(LOG_ROTATE_LEFT, dir);
+      break;
+    case OP_ROTATE_RIGHT:
+      drain(bat, costs.rotateDrain * m.done);
+      TRACE_DEBUG(LOG_ROTATE_RIGHT, dir);
+      break;
+    case OP_FORWARD:
+      if (m.done == 0) break;
+      drain(bat, costs.moveDrain * m.done);
+      TRACE_DEBUG(LOG_MOVE_FORWARD, x, y);
+      break;
+    case OP_CLEAN:
+      cleanCell(grid, x, y, bat);
+      break;
+  }
+}
+
+void updateMotion(Grid &grid,int &x,int &y,int &dir,Battery &bat){
+  unsigned long now = millis();
+  while (qCount > 0 && now - opStart >= opDuration(queue[qHead].op)) {
+    Motion &m = queue[qHead];
+    // Chain off the deadline, not `now`, so queued actions don't drift
+    // and a run goes on cell after cell without a gap
+    opStart += opDuration(m.op);
+    if (advance(grid, m, x, y, dir)) continue;
+    finish(grid, m, x, y, dir, bat);
+    qHead = (qHead + 1) % QUEUE_LEN;
+    qCount--;
+  }
 }
@@ -2,18 +2,33 @@
 #define MOVEMENT_H
 
 #include "Constants.h"
+#include "Grid.h"
+#include "RobotConfig.h"
 #include <Arduino.h>
 
-void rotateLeft(float &batteryLevel, int &robotDir);
-void rotateRight(float &batteryLevel, int &robotDir);
-void moveForward(int &robotX,int &robotY,
-                 int robotDir,float &batteryLevel);
+// Drain and duration of every action below; Constants.h values until set
+void setMotionCosts(const MotionCosts &costs);
+
+// Immediate effect of a clean; the motion queue lands it when cleanMs is up
+void cleanCell(Grid &grid,int robotX,int robotY,Battery &batteryLevel);
+
+// ── Non-blocking motion queue ───────────────────────────────────────────
+// Actions take the moveMs/rotateMs/cleanMs of the motion costs. Their effect lands
+// when that time has elapsed, so loop() keeps polling input and rendering
+// while the robot is moving. A turn or forward action may repeat: the
+// robot turns or drives on cell by cell without stopping, and the battery
+// is drained for the whole action when it ends. Runs end early at the map
+// edge, in front of an obstacle, and on reaching a dirty cell.
+enum MotionOp : uint8_t { OP_ROTATE_LEFT, OP_ROTATE_RIGHT, OP_FORWARD, OP_CLEAN };
+
+bool motionIdle();
+// count: cells or 90° turns; false if the queue is full
+bool queueMotion(MotionOp op, uint16_t count = 1);
+// Queue the turns and forward move from the current pose to cell (tx,ty)
 void stepTo(int tx,int ty,
-            int &robotX,int &robotY,int &robotDir,
-            float &batteryLevel);
-void cleanCell(int robotX,int robotY,
-               int dirtGrid[GRID_SIZE][GRID_SIZE],
-               float &batteryLevel,
-               unsigned long lastCleanTime[GRID_SIZE][GRID_SIZE]);
+            int robotX,int robotY,int robotDir);
+// Apply every action whose time is up and start the next; call every loop
+void updateMotion(Grid &grid,int &robotX,int &robotY,int &robotDir,
+                  Battery &batteryLevel);
 
-#endif // MOVEMENT_H
\ No newline at end of file
+#endif // MOVEMENT_H
@@ -0,0 +1,23 @@
+#ifndef ADAFRUIT_FT6206_H
+#define ADAFRUIT_FT6206_H
+
+#include <Arduino.h>
+
+extern bool halTouchPressed;
+extern int16_t halTouchX, halTouchY;
+
+class TS_Point {
+public:
+  TS_Point(int16_t x = 0, int16_t y = 0, int16_t z = 0) : x(x), y(y), z(z) {}
+  int16_t x, y, z;
+};
+
+// Touch controller driven by halSetTouch()
+class Adafruit_FT6206 {
+public:
+  bool begin(uint8_t thresh = 128) { (void)thresh; return true; }
+  bool touched() { return halTouchPressed; }
+  TS_Point getPoint() { return TS_Point(halTouchX, halTouchY, 1); }
+};
+
+#endif // ADAFRUIT_FT6206_H
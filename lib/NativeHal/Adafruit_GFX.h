@@ -0,0 +1,72 @@
+#ifndef ADAFRUIT_GFX_H
+#define ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+#include <algorithm>
+#include <vector>
+
+// Drawing surface that keeps the filled shapes in a host framebuffer, so
+// tests can read back what the firmware drew. Text is accepted and
+// discarded.
+class Adafruit_GFX {
+public:
+  Adafruit_GFX(int16_t w, int16_t h)
+    : _width(w), _height(h), WIDTH(w), HEIGHT(h), frame(size_t(w) * h, 0) {}
+  virtual ~Adafruit_GFX() {}
+
+  void setRotation(uint8_t r) {
+    bool swap = r & 1;
+    _width = swap ? HEIGHT : WIDTH;
+    _height = swap ? WIDTH : HEIGHT;
+  }
+  int16_t width() const { return _width; }
+  int16_t height() const { return _height; }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if (x >= 0 && x < _width && y >= 0 && y < _height) frame[size_t(y) * _width + x] = color;
+  }
+  virtual void fillScreen(uint16_t color) { std::fill(frame.begin(), frame.end(), color); }
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    for (int16_t j = y; j < y + h; j++)
+      for (int16_t i = x; i < x + w; i++) drawPixel(i, j, color);
+  }
+  // Same vertical spans as the library's fillCircle()/fillCircleHelper()
+  virtual void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    fillRect(x0, y0 - r, 1, 2 * r + 1, color);
+    int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r, px = x, py = y;
+    while (x < y) {
+      if (f >= 0) { y--; ddF_y += 2; f += ddF_y; }
+      x++; ddF_x += 2; f += ddF_x;
+      if (x < y + 1) {
+        fillRect(x0 + x, y0 - y, 1, 2 * y + 1, color);
+        fillRect(x0 - x, y0 - y, 1, 2 * y + 1, color);
+      }
+      if (y != py) {
+        fillRect(x0 + py, y0 - px, 1, 2 * px + 1, color);
+        fillRect(x0 - py, y0 - px, 1, 2 * px + 1, color);
+        py = y;
+      }
+      px = x;
+    }
+  }
+  void setCursor(int16_t, int16_t) {}
+  void setTextColor(uint16_t) {}
+  void setTextColor(uint16_t, uint16_t) {}
+  void setTextSize(uint8_t) {}
+  size_t print(const char*) { return 0; }
+  size_t print(int) { return 0; }
+  size_t printf(const char*, ...) { return 0; }
+
+  // Host only, like GFXcanvas16: the pixel at (x,y), 0 off screen
+  uint16_t getPixel(int16_t x, int16_t y) const {
+    if (x < 0 || x >= _width || y < 0 || y >= _height) return 0;
+    return frame[size_t(y) * _width + x];
+  }
+
+protected:
+  int16_t _width, _height;
+  const int16_t WIDTH, HEIGHT;
+  std::vector<uint16_t> frame;   // row-major in the current rotation
+};
+
+#endif // ADAFRUIT_GFX_H
@@ -0,0 +1,40 @@
+#ifndef ADAFRUIT_ILI9341_H
+#define ADAFRUIT_ILI9341_H
+
+#include "Adafruit_GFX.h"
+
+#define ILI9341_TFTWIDTH  240
+#define ILI9341_TFTHEIGHT 320
+
+#define ILI9341_BLACK  0x0000
+#define ILI9341_BLUE   0x001F
+#define ILI9341_RED    0xF800
+#define ILI9341_YELLOW 0xFFE0
+#define ILI9341_WHITE  0xFFFF
+
+class Adafruit_ILI9341 : public Adafruit_GFX {
+public:
+  Adafruit_ILI9341(int8_t cs, int8_t dc, int8_t rst = -1)
+    : Adafruit_GFX(ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT) { (void)cs; (void)dc; (void)rst; }
+  void begin(uint32_t freq = 0) { (void)freq; }
+  void startWrite() {}
+  void endWrite() {}
+  // Pixels written after setAddrWindow() fill the window row by row
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    winX = x; winY = y; winW = w; winH = h;
+    winPos = 0;
+  }
+  void writePixels(uint16_t* colors, uint32_t len, bool = true, bool = false) {
+    for (uint32_t i = 0; i < len && winW > 0 && winPos < uint32_t(winW) * winH; i++, winPos++)
+      drawPixel(int16_t(winX + winPos % winW), int16_t(winY + winPos / winW), colors[i]);
+  }
+  uint16_t color565(uint8_t r, uint8_t g, uint8_t b) {
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+  }
+
+private:
+  uint16_t winX = 0, winY = 0, winW = 0, winH = 0;
+  uint32_t winPos = 0;
+};
+
+#endif // ADAFRUIT_ILI9341_H
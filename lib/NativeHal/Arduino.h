@@ -0,0 +1,82 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+// Minimal Arduino core for the native simulation env. Timing goes through
+// the pluggable SimClock, I/O through the stimulus set in NativeHal.h.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include "NativeHal.h"
+
+#define HIGH 1
+#define LOW  0
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+using std::max;
+using std::min;
+using std::isinf;
+using std::isnan;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+
+void randomSeed(unsigned long seed);
+long random(long howbig);
+long random(long howsmall, long howbig);
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+// Byte sink shared by Serial and SD files
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(const uint8_t* buf, size_t len) = 0;
+  virtual int availableForWrite() { return 0; }
+  size_t write(const char* buf, size_t len) {
+    return write(reinterpret_cast<const uint8_t*>(buf), len);
+  }
+};
+
+// Models a UART with a TX_FIFO-byte FIFO: a write that doesn't fit waits,
+// on the active clock, for the line to drain at the begin() baud rate
+class HardwareSerial : public Print {
+public:
+  static const size_t TX_FIFO = 128;
+
+  using Print::write;
+  void begin(unsigned long baud) { usPerByte = baud ? 10000000.0 / baud : 0.0; }
+  int availableForWrite() override;
+  size_t print(const char* s);
+  size_t print(int v);
+  size_t print(unsigned long v);
+  size_t print(float v);
+  size_t println(const char* s = "");
+  size_t println(int v);
+  size_t println(unsigned long v);
+  size_t println(float v);
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+  size_t write(const uint8_t* buf, size_t len) override;
+
+private:
+  size_t queuedBytes();
+
+  double usPerByte = 0.0;    // 0 until begin(): writes never wait
+  uint64_t idleAtUs = 0;     // when the FIFO will have drained
+};
+
+extern HardwareSerial Serial;
+
+#endif // ARDUINO_H
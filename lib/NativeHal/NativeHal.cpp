@@ -0,0 +1,120 @@
+#include "Arduino.h"
+#include "SPI.h"
+#include "Wire.h"
+#include <chrono>
+#include <random>
+#include <thread>
+
+HardwareSerial Serial;
+TwoWire Wire;
+SPIClass SPI;
+
+static VirtualClock defaultClock;
+static SimClock* activeClock = &defaultClock;
+static int analogPins[64];
+static int digitalPins[64];
+static bool serialEcho = false;
+static std::mt19937 rng;
+
+bool halTouchPressed = false;
+int16_t halTouchX = 0, halTouchY = 0;
+
+// ── Clock ───────────────────────────────────────────────────────────────
+WallClock::WallClock()
+  : origin(std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count()) {}
+
+uint64_t WallClock::nowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count() - origin;
+}
+
+void WallClock::sleepMicros(uint64_t us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void setSimClock(SimClock* clock) { activeClock = clock ? clock : &defaultClock; }
+SimClock& simClock() { return *activeClock; }
+
+unsigned long millis() { return static_cast<unsigned long>(activeClock->nowMicros() / 1000); }
+unsigned long micros() { return static_cast<unsigned long>(activeClock->nowMicros()); }
+void delay(unsigned long ms) { activeClock->sleepMicros(uint64_t(ms) * 1000); }
+void delayMicroseconds(unsigned int us) { activeClock->sleepMicros(us); }
+
+// ── Pins ────────────────────────────────────────────────────────────────
+void halSetAnalog(uint8_t pin, int value) { if (pin < 64) analogPins[pin] = value; }
+void halSetDigital(uint8_t pin, int value) { if (pin < 64) digitalPins[pin] = value; }
+void halSetTouch(bool pressed, int16_t x, int16_t y) {
+  halTouchPressed = pressed;
+  halTouchX = x;
+  halTouchY = y;
+}
+void halEchoSerial(bool enabled) { serialEcho = enabled; }
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin < 64 && mode == INPUT_PULLUP) digitalPins[pin] = HIGH;
+}
+void digitalWrite(uint8_t pin, uint8_t val) { if (pin < 64) digitalPins[pin] = val; }
+int digitalRead(uint8_t pin) { return pin < 64 ? digitalPins[pin] : LOW; }
+int analogRead(uint8_t pin) { return pin < 64 ? analogPins[pin] : 0; }
+
+// ── Math ────────────────────────────────────────────────────────────────
+void randomSeed(unsigned long seed) { rng.seed(seed); }
+long random(long howbig) { return howbig > 0 ? long(rng() % howbig) : 0; }
+long random(long howsmall, long howbig) {
+  return howbig > howsmall ? howsmall + random(howbig - howsmall) : howsmall;
+}
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+// ── Serial ──────────────────────────────────────────────────────────────
+size_t HardwareSerial::queuedBytes() {
+  uint64_t now = activeClock->nowMicros();
+  if (usPerByte <= 0.0 || idleAtUs <= now) return 0;
+  return size_t((idleAtUs - now) / usPerByte + 0.999);
+}
+
+int HardwareSerial::availableForWrite() {
+  return int(TX_FIFO - std::min(queuedBytes(), TX_FIFO));
+}
+
+size_t HardwareSerial::write(const uint8_t* buf, size_t len) {
+  if (serialEcho) fwrite(buf, 1, len, stdout);
+  if (usPerByte <= 0.0) return len;
+  // Block until all but the last TX_FIFO bytes are on the wire
+  size_t queued = queuedBytes();
+  if (queued + len > TX_FIFO)
+    activeClock->sleepMicros(uint64_t((queued + len - TX_FIFO) * usPerByte));
+  idleAtUs = std::max(idleAtUs, activeClock->nowMicros()) + uint64_t(len * usPerByte);
+  return len;
+}
+
+static size_t serialFormat(HardwareSerial& s, const char* fmt, ...) {
+  char buf[256];
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  if (n < 0) return 0;
+  return s.write(buf, std::min<size_t>(n, sizeof(buf) - 1));
+}
+
+size_t HardwareSerial::print(const char* s) { return serialFormat(*this, "%s", s); }
+size_t HardwareSerial::print(int v) { return serialFormat(*this, "%d", v); }
+size_t HardwareSerial::print(unsigned long v) { return serialFormat(*this, "%lu", v); }
+size_t HardwareSerial::print(float v) { return serialFormat(*this, "%.2f", v); }
+size_t HardwareSerial::println(const char* s) { return serialFormat(*this, "%s\n", s); }
+size_t HardwareSerial::println(int v) { return serialFormat(*this, "%d\n", v); }
+size_t HardwareSerial::println(unsigned long v) { return serialFormat(*this, "%lu\n", v); }
+size_t HardwareSerial::println(float v) { return serialFormat(*this, "%.2f\n", v); }
+
+size_t HardwareSerial::printf(const char* fmt, ...) {
+  char buf[256];
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  if (n < 0) return 0;
+  return write(buf, std::min<size_t>(n, sizeof(buf) - 1));
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#ifndef NATIVE_HAL_H
+#define NATIVE_HAL_H
+
+#include <cstdint>
+#include "SimClock.h"
+
+// Stimulus for the host build: what the next analogRead()/digitalRead()
+// returns per pin, and whether the touch panel is pressed
+void halSetAnalog(uint8_t pin, int value);
+void halSetDigital(uint8_t pin, int value);
+void halSetTouch(bool pressed, int16_t x = 0, int16_t y = 0);
+
+// Copy Serial output to stdout (off by default to keep runs headless)
+void halEchoSerial(bool enabled);
+
+#endif // NATIVE_HAL_H
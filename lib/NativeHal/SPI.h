@@ -0,0 +1,11 @@
+#ifndef SPI_H
+#define SPI_H
+
+class SPIClass {
+public:
+  void begin() {}
+};
+
+extern SPIClass SPI;
+
+#endif // SPI_H
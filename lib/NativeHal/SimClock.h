@@ -0,0 +1,39 @@
+#ifndef SIM_CLOCK_H
+#define SIM_CLOCK_H
+
+#include <cstdint>
+
+// Time source behind millis()/micros()/delay() on the host build
+class SimClock {
+public:
+  virtual ~SimClock() {}
+  virtual uint64_t nowMicros() = 0;
+  virtual void sleepMicros(uint64_t us) = 0;
+};
+
+// Simulated time: delay() returns immediately and just advances the clock,
+// so a run proceeds as fast as the host can execute it
+class VirtualClock : public SimClock {
+public:
+  uint64_t nowMicros() override { return now; }
+  void sleepMicros(uint64_t us) override { now += us; }
+  void advance(uint64_t us) { now += us; }
+private:
+  uint64_t now = 0;
+};
+
+// Real time, for watching a run at device speed
+class WallClock : public SimClock {
+public:
+  WallClock();
+  uint64_t nowMicros() override;
+  void sleepMicros(uint64_t us) override;
+private:
+  uint64_t origin;
+};
+
+// Swap the active clock; nullptr restores the default VirtualClock
+void setSimClock(SimClock* clock);
+SimClock& simClock();
+
+#endif // SIM_CLOCK_H
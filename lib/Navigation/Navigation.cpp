@@ -0,0 +1,51 @@
+#include "Navigation.h"
+#include "Grid.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "Movement.h"
+#include <Arduino.h>
+
+void syncObstacles(const Grid &grid, House &house, uint32_t &houseObstacles) {
+  // Obstacles only change on a touch, so copy them only when they did
+  if (grid.obstacleVersion() == houseObstacles) return;
+  houseObstacles = grid.obstacleVersion();
+  for (int gy = 0; gy < grid.height(); gy++)
+    for (int gx = 0; gx < grid.width(); gx++)
+      house.setObstacle(gx, gy, grid.isObstacle(gx, gy));
+}
+
+void autoNavigate(const Grid &grid,
+                  Algorithm &algo, House &house, VacuumCleaner &vacuum,
+                  int &x, int &y, int &dir,
+                  bool &returningHome, Battery &bat,
+                  uint32_t &houseObstacles) {
+  syncObstacles(grid, house, houseObstacles);
+  for (int gy = 0; gy < grid.height(); gy++)
+    for (int gx = 0; gx < grid.width(); gx++)
+      house.setDirtLevel(gx, gy, grid.dirtAt(gx, gy));
+  vacuum.setPose(x, y, dir*90);
+
+  if (returningHome && x==0 && y==0) {
+    bat = Battery(100.0);
+    returningHome = false;
+    TRACE_INFO(LOG_DOCKED);
+  }
+
+  algo.setObjective(returningHome ? AlgorithmObjective::RETURN_HOME
+                                  : AlgorithmObjective::CLEANING);
+  {
+    PROFILE_SCOPE(PROF_PLAN);
+    algo.calculateNextMove();
+  }
+  const MotionPlan &path = algo.getCurrentPath();
+  if (path.empty()) return;
+
+  // A whole straight run or turn at once; the run stops by itself on a
+  // dirty cell, which is cleaned before the next replan
+  const MotionPrimitive &p = path.front();
+  switch (p.op) {
+    case MotionPrimitive::FORWARD:    queueMotion(OP_FORWARD, p.count);      break;
+    case MotionPrimitive::TURN_LEFT:  queueMotion(OP_ROTATE_LEFT, p.count);  break;
+    case MotionPrimitive::TURN_RIGHT: queueMotion(OP_ROTATE_RIGHT, p.count); break;
+  }
+}
@@ -0,0 +1,27 @@
+#ifndef NAVIGATION_H
+#define NAVIGATION_H
+
+#include "Constants.h"
+#include "Algorithm.h"
+#include "Grid.h"
+#include "House.h"
+#include "VacuumCleaner.h"
+
+// Robot heading as used by Movement/Display (yaw = dir * 90)
+enum Direction { NORTH = 0, EAST = 1, SOUTH = 2, WEST = 3 };
+
+// Copy the grid's obstacles into house unless houseObstacles, the grid
+// obstacle version last copied, is still current
+void syncObstacles(const Grid &grid, House &house, uint32_t &houseObstacles);
+
+// One AUTO-mode step: mirror the firmware grid into the planner's model,
+// replan, and queue the first straight run or turn of the plan on the
+// motion queue. Docking at (0,0) while returning home recharges the
+// battery and resumes cleaning. Obstacles go through syncObstacles().
+void autoNavigate(const Grid &grid,
+                  Algorithm &algo, House &house, VacuumCleaner &vacuum,
+                  int &robotX, int &robotY, int &robotDir,
+                  bool &returningHome, Battery &batteryLevel,
+                  uint32_t &houseObstacles);
+
+#endif // NAVIGATION_H
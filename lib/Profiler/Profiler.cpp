@@ -0,0 +1,96 @@
+#include "Profiler.h"
+#include <stdio.h>
+
+static ProfileStats stats[PROF_COUNT];
+static bool statsReady = false;
+static int reportLine = -1;   // next point to print, -1 when idle
+
+static const char *const POINT_NAME[PROF_COUNT] = {
+  "loop", "button", "input", "bgDrain", "act", "battery", "render",
+  "logDrain", "plan", "drawGrid", "touch"
+};
+
+// Values below 4 get a bucket each; above, each power of two is split in
+// four by the two bits below the leading one
+static uint8_t bucketOf(uint32_t us) {
+  if (us < 4) return uint8_t(us);
+  int msb = 31 - __builtin_clz(us);
+  int idx = (msb - 1)*4 + int((us >> (msb - 2)) & 3);
+  return uint8_t(min(idx, int(ProfileStats::BUCKETS) - 1));
+}
+
+static uint32_t bucketTop(uint8_t idx) {
+  if (idx < 4) return idx;
+  int msb = idx/4 + 1;
+  uint32_t lower = uint32_t(4 + idx%4) << (msb - 2);
+  return lower + (1u << (msb - 2)) - 1;
+}
+
+void ProfileStats::reset() {
+  count = 0;
+  minUs = UINT32_MAX;
+  maxUs = 0;
+  totalUs = 0;
+  for (uint8_t i = 0; i < BUCKETS; i++) hist[i] = 0;
+}
+
+void ProfileStats::record(uint32_t us) {
+  count++;
+  totalUs += us;
+  if (us < minUs) minUs = us;
+  if (us > maxUs) maxUs = us;
+  hist[bucketOf(us)]++;
+}
+
+uint32_t ProfileStats::percentileUs(uint8_t pct) const {
+  if (count == 0) return 0;
+  // Rank of the sample at pct, rounded up
+  uint32_t rank = uint32_t((uint64_t(count) * pct + 99) / 100);
+  if (rank == 0) rank = 1;
+  uint32_t seen = 0;
+  for (uint8_t i = 0; i < BUCKETS; i++) {
+    seen += hist[i];
+    if (seen >= rank) return min(bucketTop(i), maxUs);
+  }
+  return maxUs;
+}
+
+void profileReset() {
+  for (uint8_t p = 0; p < PROF_COUNT; p++) stats[p].reset();
+  statsReady = true;
+}
+
+void profileRecord(ProfilePoint point, uint32_t us) {
+  if (!statsReady) profileReset();
+  stats[point].record(us);
+}
+
+const ProfileStats& profileStats(ProfilePoint point) {
+  if (!statsReady) profileReset();
+  return stats[point];
+}
+
+void profileStartReport() {
+  if (reportLine < 0) reportLine = 0;
+}
+
+bool profileReportStep(Print& out) {
+  if (!statsReady) profileReset();
+  char line[96];
+  while (reportLine >= 0 && reportLine < PROF_COUNT) {
+    ProfileStats &s = stats[reportLine];
+    int n = snprintf(line, sizeof(line),
+                     "%-8s n=%lu min=%lu avg=%lu p99=%lu max=%lu us\n",
+                     POINT_NAME[reportLine], (unsigned long)s.count,
+                     (unsigned long)(s.count ? s.minUs : 0), (unsigned long)s.meanUs(),
+                     (unsigned long)s.percentileUs(99), (unsigned long)s.maxUs);
+    if (n < 0) n = 0;
+    if (n >= int(sizeof(line))) n = sizeof(line) - 1;
+    if (out.availableForWrite() < n) return true;
+    out.write(reinterpret_cast<const uint8_t*>(line), n);
+    s.reset();
+    reportLine++;
+  }
+  reportLine = -1;
+  return false;
+}
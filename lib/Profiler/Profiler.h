@@ -0,0 +1,73 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+// What gets timed: the loop() phases plus the hot calls inside them
+enum ProfilePoint : uint8_t {
+  PROF_LOOP,         // whole loop() body, without the frame delay
+  PROF_BUTTON,       // 1) AUTO/MANUAL toggle
+  PROF_INPUT,        // 2) joystick + touch
+  PROF_BG_DRAIN,     // 3) background battery drain
+  PROF_ACT,          // 4) motion queue, clean, next step
+  PROF_BATTERY,      // 5) return-home check
+  PROF_RENDER,       // 6) HUD + grid
+  PROF_LOG_DRAIN,    // 7) trace output
+  PROF_PLAN,         // Algorithm::calculateNextMove
+  PROF_DRAW_GRID,    // drawGrid
+  PROF_TOUCH,        // readTouchEvent
+  PROF_COUNT
+};
+
+// Duration histogram in fixed memory: four buckets per power of two, so
+// percentiles are good to about 19%
+struct ProfileStats {
+  static const uint8_t BUCKETS = 96;   // up to ~16 s
+
+  uint32_t count;
+  uint32_t minUs, maxUs;
+  uint64_t totalUs;
+  uint32_t hist[BUCKETS];
+
+  void reset();
+  void record(uint32_t us);
+  uint32_t meanUs() const { return count ? uint32_t(totalUs / count) : 0; }
+  // Upper edge of the bucket holding the given percentile, capped at maxUs
+  uint32_t percentileUs(uint8_t pct) const;
+};
+
+void profileRecord(ProfilePoint point, uint32_t us);
+const ProfileStats& profileStats(ProfilePoint point);
+void profileReset();
+
+// Start a report of every point's stats since the previous one. Lines go
+// out through profileReportStep(), which only writes what out can take
+// without blocking and resets each point once it has been printed.
+void profileStartReport();
+bool profileReportStep(Print& out);   // true while lines remain
+
+// Times the enclosing scope with micros()
+class ProfileScope {
+public:
+  explicit ProfileScope(ProfilePoint point) : point(point), startUs(micros()) {}
+  ~ProfileScope() { profileRecord(point, uint32_t(micros() - startUs)); }
+private:
+  ProfilePoint point;
+  unsigned long startUs;
+};
+
+// -DPROFILING=0 compiles every probe out
+#ifndef PROFILING
+#define PROFILING 1
+#endif
+
+#define PROFILE_CAT2(a, b) a##b
+#define PROFILE_CAT(a, b) PROFILE_CAT2(a, b)
+#if PROFILING
+#define PROFILE_SCOPE(point) ProfileScope PROFILE_CAT(profileScope, __LINE__)(point)
+#else
+#define PROFILE_SCOPE(point) ((void)0)
+#endif
+
+#endif // PROFILER_H
@@ -1,3 +1,5 @@
+
+
 #include "Sensor.h"
 #include "House.h"
 
@@ -12,24 +14,50 @@ bool Sensor::senseObstacle(int x, int y) const {
     return house->isObstacle(x, y);
 }
 
-std::vector<std::vector<int>> Sensor::senseAllDirt() const {
-    std::vector<std::vector<int>> map;
-    map.resize(GRID_SIZE, std::vector<int>(GRID_SIZE));
-    for (int i = 0; i < GRID_SIZE; ++i) {
-        for (int j = 0; j < GRID_SIZE; ++j) {
-            map[i][j] = house->getDirtLevel(i, j);
+const GridMap& Sensor::view() const {
+    return house->cells();
+}
+
+void Sensor::senseAll(GridMap& out) const {
+    if (out.width() != house->width() || out.height() != house->height()) {
+        out.resize(house->width(), house->height());
+    }
+    const GridMap& cells = house->cells();
+    uint32_t now = house->getClockMs();
+    for (int y = 0; y < out.height(); ++y) {
+        for (int x = 0; x < out.width(); ++x) {
+            out.setDirtAt(x, y, house->getDirtLevelAt(x, y, now));
+            out.setObstacleAt(x, y, cells.isObstacleAt(x, y));
         }
     }
-    return map;
 }
 
-std::vector<std::vector<bool>> Sensor::senseAllObstacles() const {
-    std::vector<std::vector<bool>> map;
-    map.resize(GRID_SIZE, std::vector<bool>(GRID_SIZE));
-    for (int i = 0; i < GRID_SIZE; ++i) {
-        for (int j = 0; j < GRID_SIZE; ++j) {
-            map[i][j] = house->isObstacle(i, j);
+int Sensor::senseChanges(GridMap& out, SenseCursor& cursor) const {
+    uint32_t now = house->getClockMs();
+    uint32_t version = house->getVersion();
+    if (cursor.version == 0 || out.width() != house->width() || out.height() != house->height()) {
+        senseAll(out);
+        cursor = {version, now};
+        return out.cellCount();
+    }
+    bool written = version != cursor.version;
+    bool aged = now != cursor.clockMs;
+    if (!written && !aged) return 0;
+
+    const GridMap& cells = house->cells();
+    int copied = 0;
+    for (int y = 0; y < out.height(); ++y) {
+        for (int x = 0; x < out.width(); ++x) {
+            // A cell untouched since the cursor only differs if it grew
+            bool changed = written && house->getCellVersion(x, y) > cursor.version;
+            if (!changed && !aged) continue;
+            int dirt = house->getDirtLevelAt(x, y, now);
+            if (!changed && dirt == house->getDirtLevelAt(x, y, cursor.clockMs)) continue;
+            out.setDirtAt(x, y, dirt);
+            out.setObstacleAt(x, y, cells.isObstacleAt(x, y));
+            ++copied;
         }
     }
-    return map;
+    cursor = {version, now};
+    return copied;
 }
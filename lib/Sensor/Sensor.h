@@ -2,11 +2,18 @@
 #ifndef SENSOR_H
 #define SENSOR_H
 
-#include <vector>
+#include <cstdint>
+#include "GridMap.h"
 
 // Forward declaration
 class House;
 
+// Where a senseChanges() caller left off
+struct SenseCursor {
+    uint32_t version = 0;   // house version last copied; 0 = nothing yet
+    uint32_t clockMs = 0;   // house time of that copy
+};
+
 class Sensor {
 public:
     // Sensor constructed with reference to the house environment
@@ -18,16 +25,22 @@ public:
     // Sense obstacle presence at a specific cell
     bool senseObstacle(int x, int y) const;
 
-    // Optional: retrieve entire dirt map
-    std::vector<std::vector<int>> senseAllDirt() const;
+    // Read-only view of the house's own packed cells, no copy. Obstacle
+    // bits are live; dirt bits are each cell's level at its last clean.
+    const GridMap& view() const;
+
+    // Copy the current dirt and obstacles of every cell into out. out is
+    // only resized (and so only allocates) when its dimensions differ.
+    void senseAll(GridMap& out) const;
 
-    // Optional: retrieve entire obstacle map
-    std::vector<std::vector<bool>> senseAllObstacles() const;
+    // Copy into out only the cells that changed since the cursor, then
+    // advance it; a fresh cursor or a differently sized out copies
+    // everything. Returns the number of cells copied. O(1) when nothing was
+    // written and no time has passed.
+    int senseChanges(GridMap& out, SenseCursor& cursor) const;
 
 private:
     House* house;
 };
 
 #endif  // SENSOR_H
-
-
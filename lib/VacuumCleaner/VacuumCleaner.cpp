@@ -0,0 +1,69 @@
+#include "VacuumCleaner.h"
+
+VacuumCleaner::VacuumCleaner(House* h, int startX, int startY, int startYaw)
+    : house(h), x(startX), y(startY), yaw(startYaw), batteryLevel(MAX_BATTERY) {}
+
+std::pair<int, int> VacuumCleaner::getPosition() const {
+    return {x, y};
+}
+
+int VacuumCleaner::getYaw() const {
+    return yaw;
+}
+
+void VacuumCleaner::setPose(int newX, int newY, int newYaw) {
+    x = newX;
+    y = newY;
+    yaw = newYaw;
+}
+
+bool VacuumCleaner::moveForward() {
+    if (batteryLevel < costs.moveDrain) return false;
+    int dx = 0, dy = 0;
+    switch (yaw) {
+        case 0:    dy = -1; break;
+        case 90:   dx = 1;  break;
+        case 180:  dy = 1;  break;
+        case 270:  dx = -1; break;
+    }
+    int nx = x + dx;
+    int ny = y + dy;
+    if (nx < 0 || nx >= house->width() || ny < 0 || ny >= house->height()) return false;
+    if (house->isObstacle(nx, ny)) return false;
+    x = nx; y = ny;
+    batteryLevel -= costs.moveDrain;
+    return true;
+}
+
+void VacuumCleaner::rotateLeft() {
+    if (batteryLevel < costs.rotateDrain) return;
+    yaw = (yaw + 270) % 360;
+    batteryLevel -= costs.rotateDrain;
+}
+
+void VacuumCleaner::rotateRight() {
+    if (batteryLevel < costs.rotateDrain) return;
+    yaw = (yaw + 90) % 360;
+    batteryLevel -= costs.rotateDrain;
+}
+
+void VacuumCleaner::clean() {
+    int dirt = house->getDirtLevel(x, y);
+    if (dirt <= 0) return;
+    Battery drain = costs.cleanDrainFor(dirt);
+    if (batteryLevel < drain) return;
+    house->resetDirt(x, y);
+    batteryLevel -= drain;
+}
+
+Battery VacuumCleaner::getBatteryLevel() const {
+    return batteryLevel;
+}
+
+void VacuumCleaner::recharge() {
+    batteryLevel = MAX_BATTERY;
+}
+
+void VacuumCleaner::setMotionCosts(const MotionCosts& newCosts) {
+    costs = newCosts;
+}
@@ -4,6 +4,7 @@
 
 #include <utility>
 #include "House.h"
+#include "RobotConfig.h"
 
 class VacuumCleaner {
 public:
@@ -14,6 +15,9 @@ public:
     std::pair<int, int> getPosition() const;
     int getYaw() const;
 
+    // Place the vacuum directly, e.g. to mirror an externally driven robot
+    void setPose(int x, int y, int yaw);
+
     // Movement commands
     // Returns true if move successful (enough battery, no obstacle, within bounds)
     bool moveForward();
@@ -24,20 +28,21 @@ public:
     void clean();
 
     // Battery status
-    float getBatteryLevel() const;
+    Battery getBatteryLevel() const;
     void recharge();
 
+    // Drain per action; defaults to the firmware's Constants.h values
+    void setMotionCosts(const MotionCosts& costs);
+
 private:
     House* house;
     int x;
     int y;
     int yaw;  // 0 = up, 90 = right, 180 = down, 270 = left
-    float batteryLevel;
+    Battery batteryLevel;
+    MotionCosts costs;
 
-    static constexpr float MAX_BATTERY = 100.0f;
-    static constexpr float MOVE_BATTERY_COST = 1.0f;
-    static constexpr float ROTATE_BATTERY_COST = 0.5f;
-    static constexpr float CLEAN_BATTERY_COST = 0.2f;
+    static constexpr Battery MAX_BATTERY = Battery(100.0);
 };
 
 #endif // VACUUMCLEANER_H
\ No newline at end of file
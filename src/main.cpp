@@ -3,7 +3,7 @@
 #include <Wire.h>
 
 #include "Constants.h"
-#include "Logger.h"
+#include "Trace.h"
 #include "Sensor.h"
 #include "House.h"
 #include "VacuumCleaner.h"
@@ -14,79 +14,163 @@
 #include "Grid.h"
 #include "Movement.h"
 #include "Navigation.h"
+#include "Profiler.h"
+#include "RobotConfig.h"
 
+RobotConfig   config;
+Grid          grid;
 House         house;
-VacuumCleaner vacuum(0,0,100.0f);
-Sensor        sensor(house, vacuum);
+VacuumCleaner vacuum(&house);
+Sensor        sensor(&house);
 Algorithm     algo(&house, &vacuum);
 
 bool autoMode      = false;
 bool returningHome = false;
 int  robotX = 0, robotY = 0, robotDir = NORTH;
-float batteryLevel = 100.0f;
+Battery batteryLevel(100.0);
+// Grid obstacle version last mirrored into house by syncObstacles()
+uint32_t houseObstacles = 0;
 static bool lastBtn = HIGH;
 static unsigned long lastBgDrain = 0;
 
+// Worst gap between two loop() starts, i.e. the longest an input edge can
+// wait before it is polled; reported over Serial every LATENCY_REPORT_MS,
+// followed by the per-phase profile
+static const unsigned long LATENCY_REPORT_MS = 10000;
+static unsigned long lastLoopStartUs = 0;
+static unsigned long worstLoopGapUs = 0;
+static unsigned long lastLatencyReport = 0;
+
+// Battery level as whole percent and tenths, for the trace args; unused
+// when TRACE_LEVEL compiles those out
+[[maybe_unused]] static int16_t batteryWhole() { return int16_t(batteryLevel.tenths() / 10); }
+[[maybe_unused]] static int16_t batteryTenth() { return int16_t(batteryLevel.tenths() % 10); }
+
 void setup() {
   Serial.begin(115200);
   delay(100);
   setupDisplay();
+  setTiledRendering(true);
   setupInput();
-  setupGrid();
-  vacuum.resetSteps();
+  grid.setup();
+  setMotionCosts(config.motion);
+  vacuum.setMotionCosts(config.motion);
+  algo.setMotionCosts(config.motion);
+  algo.setPlannerWeights(config.planner);
+  algo.setPlannerMode(PlannerMode::INCREMENTAL);
 }
 
 void loop() {
-  // 1) Toggle AUTO/MANUAL
-  bool curBtn = digitalRead(JOY_SW);
-  if (lastBtn==HIGH && curBtn==LOW) {
-    autoMode = !autoMode;
-    Serial.println(autoMode ? "Switched to AUTO" : "Switched to MANUAL");
+  unsigned long loopStartUs = micros();
+  if (lastLoopStartUs != 0)
+    worstLoopGapUs = max(worstLoopGapUs, loopStartUs - lastLoopStartUs);
+  lastLoopStartUs = loopStartUs;
+  if (millis() - lastLatencyReport >= LATENCY_REPORT_MS) {
+    lastLatencyReport = millis();
+    Serial.printf("Worst input latency: %lu ms\n", worstLoopGapUs / 1000);
+    const DisplayStats &ds = getDisplayStats();
+    Serial.printf("Last frame: %lu SPI bytes, %u writes, %lu us\n",
+                  (unsigned long)ds.spiBytes, ds.writes, (unsigned long)ds.frameUs);
+    worstLoopGapUs = 0;
+    const PathCache &pc = algo.getPathCache();
+    [[maybe_unused]] unsigned long lookups = pc.stats().hits + pc.stats().misses;
+    TRACE_INFO(LOG_PATH_CACHE,
+               int16_t(lookups ? pc.stats().hits * 100 / lookups : 0),
+               int16_t(pc.size()), int16_t(std::min<size_t>(pc.memoryBytes(), INT16_MAX)));
+    profileStartReport();
   }
-  lastBtn = curBtn;
 
-  // 2) Read inputs
-  readJoystickEvent();
-  readTouchEvent(returningHome, obstacleGrid);
+  {
+    PROFILE_SCOPE(PROF_LOOP);
 
-  // 3) Background drain
-  if (millis() - lastBgDrain >= BAT_DRAIN_BG_INTERVAL) {
-    lastBgDrain = millis();
-    batteryLevel = max(0.0f, batteryLevel - BAT_DRAIN_BG_AMOUNT);
-    Serial.println("Background drain");
-  }
+    // 1) Toggle AUTO/MANUAL
+    {
+      PROFILE_SCOPE(PROF_BUTTON);
+      bool curBtn = digitalRead(JOY_SW);
+      if (lastBtn==HIGH && curBtn==LOW) {
+        autoMode = !autoMode;
+        TRACE_INFO(autoMode ? LOG_MODE_AUTO : LOG_MODE_MANUAL);
+      }
+      lastBtn = curBtn;
+    }
 
-  // 4) Act
-  if (joyEvent.active && !autoMode) {
-    int dx[4]={0,1,0,-1}, dy[4]={-1,0,1,0};
-    stepTo(robotX + dx[joyEvent.dir],
-           robotY + dy[joyEvent.dir],
-           robotX, robotY, robotDir,
-           batteryLevel);
-  }
-  else if (autoMode) {
-    autoNavigate(algo,
-                 robotX, robotY, robotDir,
-                 returningHome, batteryLevel);
-  }
+    // 2) Read inputs
+    {
+      PROFILE_SCOPE(PROF_INPUT);
+      readJoystickEvent();
+      PROFILE_SCOPE(PROF_TOUCH);
+      readTouchEvent(grid, returningHome, robotX, robotY);
+    }
 
-  // 5) Clean, check battery, grow dirt
-  cleanCell(robotX,robotY,
-            dirtGrid, batteryLevel,
-            lastCleanTime);
+    // 3) Background drain
+    {
+      PROFILE_SCOPE(PROF_BG_DRAIN);
+      if (millis() - lastBgDrain >= BAT_DRAIN_BG_INTERVAL) {
+        lastBgDrain = millis();
+        batteryLevel = std::max(Battery(), batteryLevel - Battery(BAT_DRAIN_BG_AMOUNT));
+        TRACE_DEBUG(LOG_BACKGROUND_DRAIN, batteryWhole(), batteryTenth());
+      }
+    }
 
-  if (batteryLevel <= BAT_LOW_THRESHOLD && !returningHome) {
-    returningHome = true;
-    Serial.println("Battery low – heading home");
-  }
+    // 4) Act: land finished motion, then clean or start the next step
+    {
+      PROFILE_SCOPE(PROF_ACT);
+      updateMotion(grid, robotX, robotY, robotDir, batteryLevel);
+      if (motionIdle()) {
+        if (grid.dirtAt(robotX, robotY) > 0) {
+          queueMotion(OP_CLEAN);
+        }
+        else if (joyEvent.active && !autoMode) {
+          int dx[4]={0,1,0,-1}, dy[4]={-1,0,1,0};
+          stepTo(robotX + dx[joyEvent.dir],
+                 robotY + dy[joyEvent.dir],
+                 robotX, robotY, robotDir);
+        }
+        else if (autoMode) {
+          autoNavigate(grid, algo, house, vacuum,
+                       robotX, robotY, robotDir,
+                       returningHome, batteryLevel, houseObstacles);
+        }
+      }
+    }
+
+    // 5) Check battery
 
-  updateDirtLevels();
+    // Head home once the battery only just covers the trip back; fall back to
+    // the fixed threshold if home is currently walled off
+    {
+      PROFILE_SCOPE(PROF_BATTERY);
+      // Obstacles drawn in MANUAL mode must count too
+      syncObstacles(grid, house, houseObstacles);
+      Battery homeReserve = algo.energyToHome(robotX, robotY, robotDir*90,
+                                              config.motion.moveDrain,
+                                              config.motion.rotateDrain);
+      if (homeReserve == Battery::max()) homeReserve = config.lowThreshold;
+      else                               homeReserve += config.homeMargin;
+      if (batteryLevel <= homeReserve && !returningHome) {
+        returningHome = true;
+        TRACE_WARN(LOG_BATTERY_LOW, batteryWhole(), batteryTenth());
+      }
+    }
 
-  // 6) Render
-  updateHUD(returningHome, autoMode, batteryLevel);
-  drawGrid(robotX,robotY,
-           dirtGrid, obstacleGrid,
-           robotDir);
+    // 6) Render
+    {
+      PROFILE_SCOPE(PROF_RENDER);
+      updateHUD(returningHome, autoMode, batteryLevel);
+      PROFILE_SCOPE(PROF_DRAW_GRID);
+      drawGrid(robotX,robotY,
+               grid,
+               robotDir);
+    }
+
+    // 7) Format queued trace events and the profile report, only as far as
+    // the UART FIFO has room
+    {
+      PROFILE_SCOPE(PROF_LOG_DRAIN);
+      eventLog.drainAvailable(Serial);
+      profileReportStep(Serial);
+    }
+  }
 
   delay(50);
 }
@@ -0,0 +1,175 @@
+#include "FixedCheck.h"
+#include "Layouts.h"
+#include "Algorithm.h"
+#include "GridSearch.h"
+#include "House.h"
+#include "RobotConfig.h"
+#include "VacuumCleaner.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Largest charge difference accepted after a full discharge, in percent
+static const double BATTERY_TOLERANCE = 0.01;
+// Plan costs are multiples of the weights, so integer and float must agree
+static const double COST_TOLERANCE = 1e-3;
+static const int POSES = 20;
+static const float DIRT_FRACTION = 0.05f;
+
+struct Check {
+  const char* name;
+  int cases = 0;
+  int mismatches = 0;    // decisions or plans that came out differently
+  double maxError = 0;
+  double tolerance = 0;
+
+  void add(double error, bool mismatch) {
+    cases++;
+    maxError = std::max(maxError, error);
+    if (mismatch) mismatches++;
+  }
+  bool passed() const { return mismatches == 0 && maxError <= tolerance; }
+};
+
+// Firmware drains from full to empty, once in float as before and once in
+// Battery. Counts the steps at which the low-battery test or the tenths
+// shown on the HUD came out differently by more than rounding.
+static void checkBattery(uint32_t seed, Check& drain, Check& hud) {
+  const MotionCosts costs;
+  const RobotConfig config;
+  std::minstd_rand rng(seed);
+  float f = 100.0f;
+  Battery b(100.0);
+  while (f > 0.0f) {
+    float df;
+    Battery db;
+    switch (rng() % 4) {
+      case 0:  df = BAT_DRAIN_MOVE;   db = costs.moveDrain;   break;
+      case 1:  df = BAT_DRAIN_ROTATE; db = costs.rotateDrain; break;
+      case 2: {
+        int dirt = 1 + int(rng() % MAX_DIRT);
+        df = dirt <= BAT_DRAIN_CLEAN_THRESH ? BAT_DRAIN_CLEAN : BAT_DRAIN_CLEAN_HEAVY;
+        db = costs.cleanDrainFor(dirt);
+        break;
+      }
+      default: df = BAT_DRAIN_BG_AMOUNT; db = Battery(BAT_DRAIN_BG_AMOUNT); break;
+    }
+    f = std::max(0.0f, f - df);
+    b = std::max(Battery(), b - db);
+    double error = std::fabs(double(f) - b.toFloat());
+    // Within the tolerance of the threshold either answer is fine
+    bool lowDiffers = (f <= BAT_LOW_THRESHOLD) != (b <= config.lowThreshold);
+    drain.add(error, lowDiffers && std::fabs(f - BAT_LOW_THRESHOLD) > BATTERY_TOLERANCE);
+    // Float tenths may round either way on an exact .x5, so only a step of
+    // more than one tenth counts
+    int ft = int(f * 10.0f + 0.5f);
+    hud.add(error, std::abs(ft - b.tenths()) > 1);
+  }
+}
+
+template <typename Cost>
+struct NearestDirtPolicy {
+  static const bool REVERSE = false;
+  const GridMap& map;
+  bool isGoal(int x, int y) const { return map.dirtAt(x, y) > 0; }
+  Cost heuristic(int, int) const { return 0; }
+};
+
+template <typename Cost>
+struct HomeFieldPolicy {
+  static const bool REVERSE = true;
+  bool isGoal(int, int) const { return false; }
+  Cost heuristic(int, int) const { return 0; }
+};
+
+// Integer D* Lite plans against a float Dijkstra to the nearest dirt, and
+// the integer return-home field against the same field in float
+static void checkPlanner(Layout layout, int size, uint32_t seed,
+                         Check& incremental, Check& field) {
+  House house(size, size, seed);
+  applyLayout(house, layout, seed);
+  scatterDirt(house, seed, DIRT_FRACTION);
+  VacuumCleaner vacuum(&house);
+  Algorithm algo(&house, &vacuum);
+  algo.setPlannerMode(PlannerMode::INCREMENTAL);
+  algo.setObjective(AlgorithmObjective::CLEANING);
+  const PlannerWeights w;
+  const int numStates = size * size * NUM_HEADINGS;
+
+  SearchWorkspace<float> ref;
+  ref.resize(numStates, w.move, w.rotate);
+  std::minstd_rand rng(seed);
+  for (int i = 0; i < POSES; i++) {
+    int x = int(rng() % size), y = int(rng() % size), yaw = int(rng() % 4) * 90;
+    if (house.isObstacle(x, y)) continue;
+    vacuum.setPose(x, y, yaw);
+    algo.calculateNextMove();
+    const PlanEstimate& e = algo.getPlanEstimate();
+    double planned = e.moves * double(w.move) + e.rotations * double(w.rotate);
+
+    ref.reset();
+    ref.seed((y * size + x) * NUM_HEADINGS + yaw / 90, 0.0f);
+    int goal = searchStates(ref, house.cells(), NearestDirtPolicy<float>{house.cells()},
+                            w.move, w.rotate);
+    bool found = goal >= 0;
+    bool planFound = !algo.getCurrentPath().empty() || house.getDirtLevel(x, y) > 0;
+    double expected = found ? ref.cost[goal] : 0.0;
+    incremental.add(found && planFound ? std::fabs(planned - expected) : 0.0,
+                    found != planFound);
+  }
+
+  SearchWorkspace<float> wsFloat;
+  SearchWorkspace<PlanCost> wsInt;
+  wsFloat.resize(numStates, w.move, w.rotate);
+  wsInt.resize(numStates, toPlanCost(w.move), toPlanCost(w.rotate));
+  wsFloat.reset();
+  wsInt.reset();
+  for (int h = 0; h < NUM_HEADINGS; h++) {
+    wsFloat.seed(h, 0.0f);
+    wsInt.seed(h, 0);
+  }
+  searchStates(wsFloat, house.cells(), HomeFieldPolicy<float>{}, w.move, w.rotate);
+  searchStates(wsInt, house.cells(), HomeFieldPolicy<PlanCost>{},
+               toPlanCost(w.move), toPlanCost(w.rotate));
+  for (int s = 0; s < numStates; s++) {
+    bool reachedFloat = wsFloat.costOf(s) != unreachableCost<float>();
+    bool reachedInt = wsInt.costOf(s) != unreachableCost<PlanCost>();
+    double error = reachedFloat && reachedInt
+                       ? std::fabs(double(wsInt.costOf(s)) / COST_SCALE - wsFloat.costOf(s))
+                       : 0.0;
+    field.add(error, reachedFloat != reachedInt);
+  }
+}
+
+int runFixedCheck(int argc, char** argv) {
+  int seeds = 20;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--seeds") && i + 1 < argc) seeds = atoi(argv[++i]);
+  }
+
+  Check drain{"battery_low_test"}, hud{"battery_hud_tenths"};
+  Check incremental{"incremental_plan_cost"}, field{"home_field_cost"};
+  drain.tolerance = hud.tolerance = BATTERY_TOLERANCE;
+  incremental.tolerance = field.tolerance = COST_TOLERANCE;
+
+  for (int seed = 1; seed <= seeds; seed++) checkBattery(uint32_t(seed), drain, hud);
+  const Layout layouts[] = {Layout::EMPTY, Layout::ROOMS, Layout::MAZE,
+                            Layout::RANDOM_DENSITY, Layout::CLUTTERED};
+  for (Layout layout : layouts)
+    for (int size : {20, 64})
+      for (int seed = 1; seed <= seeds; seed++)
+        checkPlanner(layout, size, uint32_t(seed), incremental, field);
+
+  bool ok = true;
+  printf("check,cases,mismatches,max_error,tolerance,result\n");
+  for (const Check* c : {&drain, &hud, &incremental, &field}) {
+    printf("%s,%d,%d,%.6f,%.6f,%s\n", c->name, c->cases, c->mismatches, c->maxError,
+           c->tolerance, c->passed() ? "ok" : "FAIL");
+    ok = ok && c->passed();
+  }
+  return ok ? 0 : 1;
+}
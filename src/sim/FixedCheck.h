@@ -0,0 +1,12 @@
+// Host check that the fixed-point battery model and the integer planner
+// costs reproduce the float results they replaced
+#ifndef FIXED_CHECK_H
+#define FIXED_CHECK_H
+
+// program --fixed-check [--seeds N]
+// Replays random drain sequences in float and in Battery, and compares
+// integer plan costs with float searches over the seeded layouts. Prints
+// one CSV row per check; exits non-zero if any is outside its tolerance.
+int runFixedCheck(int argc, char** argv);
+
+#endif // FIXED_CHECK_H
@@ -0,0 +1,232 @@
+#include "FleetSim.h"
+#include "WorkStealingPool.h"
+#include "House.h"
+#include "VacuumCleaner.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// A mission ends when the robot docks after heading home, runs flat away
+// from home, or hits this much house time
+static const unsigned long MISSION_LIMIT_MS = 2UL * 60 * 60 * 1000;
+
+const char* plannerModeName(PlannerMode mode) {
+  switch (mode) {
+    case PlannerMode::FULL_REPLAN: return "full";
+    case PlannerMode::INCREMENTAL: return "incremental";
+    case PlannerMode::COVERAGE:    return "coverage";
+  }
+  return "?";
+}
+
+bool parsePlannerMode(const char* name, PlannerMode& mode) {
+  for (PlannerMode m : {PlannerMode::FULL_REPLAN, PlannerMode::INCREMENTAL,
+                        PlannerMode::COVERAGE}) {
+    if (!strcmp(name, plannerModeName(m))) {
+      mode = m;
+      return true;
+    }
+  }
+  return false;
+}
+
+// One charge of the firmware's AUTO mode: clean until the battery only just
+// covers the trip home, then drive back to the dock. Drain and timing come
+// from the config; the VacuumCleaner only carries the pose for the planner.
+MissionResult runMission(const MissionParams& p, uint32_t seed) {
+  House house(p.size, p.size, seed);
+  applyLayout(house, p.layout, seed, p.density);
+  VacuumCleaner vacuum(&house);
+  Algorithm algo(&house, &vacuum);
+  algo.setPlannerMode(p.mode);
+  algo.setMotionCosts(p.config.motion);
+  algo.setPlannerWeights(p.config.planner);
+  const MotionCosts& costs = p.config.motion;
+
+  std::vector<bool> covered(size_t(p.size) * p.size, false);
+  int x = 0, y = 0, dir = 0;
+  Battery battery(100.0);
+  bool returning = false;
+  unsigned long now = 0, lastBgDrain = 0;
+  MissionResult r;
+
+  auto spend = [&](Battery drain, unsigned long ms) {
+    battery = std::max(Battery(), battery - drain);
+    now += ms;
+    house.update(ms / 1000.0f);
+    while (now - lastBgDrain >= BAT_DRAIN_BG_INTERVAL) {
+      lastBgDrain += BAT_DRAIN_BG_INTERVAL;
+      battery = std::max(Battery(), battery - Battery(BAT_DRAIN_BG_AMOUNT));
+    }
+  };
+
+  while (now < MISSION_LIMIT_MS) {
+    if (battery <= Battery()) {
+      r.stranded = true;
+      break;
+    }
+    if (returning && x == 0 && y == 0) break;
+
+    int d = house.getDirtLevel(x, y);
+    if (d > 0 && (p.cleanOnReturn || !returning)) {
+      house.resetDirt(x, y);
+      covered[size_t(y) * p.size + x] = true;
+      r.dirtRemoved += d;
+      spend(costs.cleanDrainFor(d), costs.cleanMs);
+      continue;
+    }
+
+    if (!returning) {
+      Battery reserve = algo.energyToHome(x, y, dir * 90, costs.moveDrain, costs.rotateDrain);
+      reserve = reserve == Battery::max() ? p.config.lowThreshold : reserve + p.config.homeMargin;
+      if (battery <= reserve) returning = true;
+    }
+
+    vacuum.setPose(x, y, dir * 90);
+    // A coverage tour ends where the charge would; the reserve above
+    // still turns the robot home in time
+    algo.setCoverageBudget(battery);
+    algo.setObjective(returning ? AlgorithmObjective::RETURN_HOME
+                                : AlgorithmObjective::CLEANING);
+    algo.calculateNextMove();
+    r.replans++;
+    const MotionPlan& path = algo.getCurrentPath();
+    if (path.empty()) {
+      // Nothing reachable left to clean, or home is walled off
+      if (returning) {
+        r.stranded = true;
+        break;
+      }
+      returning = true;
+      continue;
+    }
+
+    // One primitive per replan, like the firmware; a run stops on a cell
+    // that is to be cleaned
+    const MotionPrimitive& cmd = path.front();
+    if (cmd.op == MotionPrimitive::FORWARD) {
+      static const int dx[4] = {0, 1, 0, -1}, dy[4] = {-1, 0, 1, 0};
+      int moved = 0;
+      while (moved < cmd.count) {
+        x += dx[dir];
+        y += dy[dir];
+        moved++;
+        if (house.getDirtLevel(x, y) > 0 && (p.cleanOnReturn || !returning)) break;
+      }
+      spend(costs.moveDrain * moved, costs.moveMs * moved);
+    } else {
+      dir = (dir + (cmd.op == MotionPrimitive::TURN_LEFT ? 3 : 1) * cmd.count) % 4;
+      spend(costs.rotateDrain * cmd.count, costs.rotateMs * cmd.count);
+    }
+  }
+
+  long dirt = 0;
+  for (int cy = 0; cy < p.size; cy++) {
+    for (int cx = 0; cx < p.size; cx++) {
+      if (house.isObstacle(cx, cy)) continue;
+      r.freeCells++;
+      dirt += house.getDirtLevel(cx, cy);
+      if (covered[size_t(cy) * p.size + cx]) r.cellsCovered++;
+    }
+  }
+  r.meanDirt = r.freeCells ? double(dirt) / r.freeCells : 0.0;
+  r.batteryLeft = battery.toFloat();
+  r.durationMs = now;
+  return r;
+}
+
+static std::vector<float> parseFloats(char* list) {
+  std::vector<float> out;
+  for (char* tok = strtok(list, ","); tok; tok = strtok(nullptr, ","))
+    out.push_back(float(atof(tok)));
+  return out;
+}
+
+int runFleetSim(int argc, char** argv) {
+  int missions = 200;
+  unsigned threads = std::thread::hardware_concurrency();
+  MissionParams base;
+  std::vector<float> margins = {0.0f, BAT_HOME_MARGIN, 10.0f};
+  std::vector<PlannerMode> modes = {PlannerMode::FULL_REPLAN, PlannerMode::INCREMENTAL};
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--missions") && i + 1 < argc) {
+      missions = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+      threads = unsigned(atoi(argv[++i]));
+    } else if (!strcmp(argv[i], "--size") && i + 1 < argc) {
+      base.size = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--density") && i + 1 < argc) {
+      base.density = float(atof(argv[++i]));
+    } else if (!strcmp(argv[i], "--layout") && i + 1 < argc) {
+      if (!parseLayout(argv[++i], base.layout)) {
+        fprintf(stderr, "unknown layout %s\n", argv[i]);
+        return 1;
+      }
+    } else if (!strcmp(argv[i], "--no-clean-on-return")) {
+      base.cleanOnReturn = false;
+    } else if (!strcmp(argv[i], "--margins") && i + 1 < argc) {
+      margins = parseFloats(argv[++i]);
+    } else if (!strcmp(argv[i], "--modes") && i + 1 < argc) {
+      modes.clear();
+      for (char* tok = strtok(argv[++i], ","); tok; tok = strtok(nullptr, ",")) {
+        PlannerMode m;
+        if (!parsePlannerMode(tok, m)) {
+          fprintf(stderr, "unknown planner mode %s\n", tok);
+          return 1;
+        }
+        modes.push_back(m);
+      }
+    }
+  }
+
+  std::vector<MissionParams> sets;
+  for (PlannerMode mode : modes) {
+    for (float margin : margins) {
+      MissionParams p = base;
+      p.mode = mode;
+      p.config.homeMargin = Battery(margin);
+      sets.push_back(p);
+    }
+  }
+
+  // Job i is seed i % missions of parameter set i / missions; every job
+  // writes only its own result slot
+  size_t jobs = sets.size() * size_t(missions);
+  std::vector<MissionResult> results(jobs);
+  WorkStealingPool pool(threads);
+  auto t0 = std::chrono::steady_clock::now();
+  pool.run(jobs, [&](size_t i) {
+    results[i] = runMission(sets[i / missions], uint32_t(i % missions) + 1);
+  });
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  printf("layout,size,density,mode,margin,missions,coverage_pct,stranded_pct,"
+         "mean_dirt,battery_left,minutes,replans\n");
+  for (size_t s = 0; s < sets.size(); s++) {
+    const MissionParams& p = sets[s];
+    double coverage = 0, dirt = 0, battery = 0, minutes = 0, replans = 0;
+    int stranded = 0;
+    for (int m = 0; m < missions; m++) {
+      const MissionResult& r = results[s * missions + m];
+      coverage += r.freeCells ? 100.0 * r.cellsCovered / r.freeCells : 0.0;
+      dirt += r.meanDirt;
+      battery += r.batteryLeft;
+      minutes += r.durationMs / 60000.0;
+      replans += r.replans;
+      stranded += r.stranded;
+    }
+    double n = missions ? missions : 1;
+    printf("%s,%d,%.2f,%s,%.1f,%d,%.1f,%.1f,%.2f,%.1f,%.1f,%.0f\n",
+           layoutName(p.layout), p.size, p.density, plannerModeName(p.mode), p.config.homeMargin.toFloat(),
+           missions, coverage / n, 100.0 * stranded / n, dirt / n, battery / n,
+           minutes / n, replans / n);
+  }
+  fprintf(stderr, "%zu missions on %u threads in %.2f s (%.0f missions/s)\n",
+          jobs, pool.size(), secs, jobs / secs);
+  return 0;
+}
@@ -0,0 +1,46 @@
+// Monte-Carlo batch of full cleaning missions, run in parallel on all host
+// cores to tune the battery thresholds and planner settings
+#ifndef FLEET_SIM_H
+#define FLEET_SIM_H
+
+#include <cstdint>
+#include "Algorithm.h"
+#include "Layouts.h"
+#include "RobotConfig.h"
+
+struct MissionParams {
+  int size = GRID_SIZE;
+  Layout layout = Layout::RANDOM_DENSITY;
+  float density = 0.15f;
+  PlannerMode mode = PlannerMode::INCREMENTAL;
+  bool cleanOnReturn = true;   // the firmware also cleans cells it passes going home
+  RobotConfig config;
+};
+
+struct MissionResult {
+  bool stranded = false;
+  int freeCells = 0;
+  int cellsCovered = 0;     // distinct free cells cleaned at least once
+  long dirtRemoved = 0;     // sum of the levels cleaned
+  double meanDirt = 0;      // over free cells when the mission ended
+  float batteryLeft = 0;
+  unsigned long durationMs = 0;
+  int replans = 0;
+};
+
+const char* plannerModeName(PlannerMode mode);
+// Parse a name as printed by plannerModeName(); false if unknown
+bool parsePlannerMode(const char* name, PlannerMode& mode);
+
+// One charge of the firmware's AUTO mode in a house built from seed
+MissionResult runMission(const MissionParams& params, uint32_t seed);
+
+// program --fleet [--missions N] [--threads T] [--size S] [--layout L]
+//                 [--density D] [--margins 0,5,10] [--modes full,incremental]
+//                 [--no-clean-on-return]
+// Every parameter set (margin x mode) runs the same N seeded houses. Writes
+// one CSV row of aggregated statistics per parameter set to stdout and the
+// throughput to stderr.
+int runFleetSim(int argc, char** argv);
+
+#endif // FLEET_SIM_H
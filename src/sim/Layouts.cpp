@@ -0,0 +1,126 @@
+#include "Layouts.h"
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+static const char* const LAYOUT_NAMES[] = {
+  "empty", "rooms", "maze", "random", "cluttered"
+};
+
+const char* layoutName(Layout layout) {
+  return LAYOUT_NAMES[static_cast<int>(layout)];
+}
+
+bool parseLayout(const char* name, Layout& layout) {
+  for (int i = 0; i < 5; i++) {
+    if (!strcmp(name, LAYOUT_NAMES[i])) {
+      layout = static_cast<Layout>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+static void clearObstacles(House& house) {
+  for (int y = 0; y < house.height(); y++)
+    for (int x = 0; x < house.width(); x++) house.setObstacle(x, y, false);
+}
+
+// Walls every ROOM cells, each wall segment between two junctions gets a
+// one-cell door at a random offset
+static void buildRooms(House& house, std::minstd_rand& rng) {
+  const int ROOM = 8;
+  int w = house.width(), h = house.height();
+  for (int y = ROOM; y < h; y += ROOM) {
+    for (int x = 0; x < w; x++) house.setObstacle(x, y, true);
+    for (int x0 = 0; x0 < w; x0 += ROOM) {
+      int span = std::min(ROOM, w - x0);
+      house.setObstacle(x0 + 1 + int(rng() % std::max(span - 1, 1)), y, false);
+    }
+  }
+  for (int x = ROOM; x < w; x += ROOM) {
+    for (int y = 0; y < h; y++) {
+      if (y % ROOM != 0) house.setObstacle(x, y, true);
+    }
+    for (int y0 = 0; y0 < h; y0 += ROOM) {
+      int span = std::min(ROOM, h - y0);
+      house.setObstacle(x, y0 + 1 + int(rng() % std::max(span - 1, 1)), false);
+    }
+  }
+}
+
+// Passages on even coordinates, carved by a depth-first backtracker
+static void buildMaze(House& house, std::minstd_rand& rng) {
+  int w = house.width(), h = house.height();
+  for (int y = 0; y < h; y++)
+    for (int x = 0; x < w; x++) house.setObstacle(x, y, true);
+  int cw = (w + 1) / 2, ch = (h + 1) / 2;
+  std::vector<bool> seen(size_t(cw) * ch, false);
+  std::vector<int> stack;
+  stack.push_back(0);
+  seen[0] = true;
+  house.setObstacle(0, 0, false);
+  const int DX[4] = {0, 1, 0, -1}, DY[4] = {-1, 0, 1, 0};
+  while (!stack.empty()) {
+    int c = stack.back();
+    int cx = c % cw, cy = c / cw;
+    int options[4], n = 0;
+    for (int d = 0; d < 4; d++) {
+      int nx = cx + DX[d], ny = cy + DY[d];
+      if (nx >= 0 && nx < cw && ny >= 0 && ny < ch && !seen[ny * cw + nx]) options[n++] = d;
+    }
+    if (n == 0) {
+      stack.pop_back();
+      continue;
+    }
+    int d = options[rng() % n];
+    int nx = cx + DX[d], ny = cy + DY[d];
+    seen[ny * cw + nx] = true;
+    house.setObstacle(2 * cx + DX[d], 2 * cy + DY[d], false);
+    house.setObstacle(2 * nx, 2 * ny, false);
+    stack.push_back(ny * cw + nx);
+  }
+}
+
+static void buildRandom(House& house, std::minstd_rand& rng, float density) {
+  std::uniform_real_distribution<float> u(0.0f, 1.0f);
+  for (int y = 0; y < house.height(); y++)
+    for (int x = 0; x < house.width(); x++) house.setObstacle(x, y, u(rng) < density);
+}
+
+// About one 1x1..3x4 piece of furniture per 25 cells
+static void buildCluttered(House& house, std::minstd_rand& rng) {
+  int w = house.width(), h = house.height();
+  int pieces = w * h / 25;
+  for (int i = 0; i < pieces; i++) {
+    int fw = 1 + int(rng() % 3), fh = 1 + int(rng() % 4);
+    int x0 = int(rng() % w), y0 = int(rng() % h);
+    for (int y = y0; y < std::min(y0 + fh, h); y++)
+      for (int x = x0; x < std::min(x0 + fw, w); x++) house.setObstacle(x, y, true);
+  }
+}
+
+void applyLayout(House& house, Layout layout, uint32_t seed, float density) {
+  std::minstd_rand rng(seed);
+  clearObstacles(house);
+  switch (layout) {
+    case Layout::EMPTY:                                      break;
+    case Layout::ROOMS:          buildRooms(house, rng);     break;
+    case Layout::MAZE:           buildMaze(house, rng);      break;
+    case Layout::RANDOM_DENSITY: buildRandom(house, rng, density); break;
+    case Layout::CLUTTERED:      buildCluttered(house, rng); break;
+  }
+  house.setObstacle(0, 0, false);
+}
+
+void scatterDirt(House& house, uint32_t seed, float fraction) {
+  std::minstd_rand rng(seed ^ 0x5bd1e995u);
+  std::uniform_real_distribution<float> u(0.0f, 1.0f);
+  for (int y = 0; y < house.height(); y++) {
+    for (int x = 0; x < house.width(); x++) {
+      bool dirty = !house.isObstacle(x, y) && u(rng) < fraction;
+      house.setDirtLevel(x, y, dirty ? 1 + int(rng() % 7) : 0);
+    }
+  }
+}
@@ -0,0 +1,28 @@
+// Reproducible obstacle layouts for host-side planner runs. Every layout
+// keeps home (0,0) free; the same seed always gives the same house.
+#ifndef LAYOUTS_H
+#define LAYOUTS_H
+
+#include <cstdint>
+#include "House.h"
+
+enum class Layout {
+  EMPTY,            // no obstacles
+  ROOMS,            // walls on a room grid, one door per wall
+  MAZE,             // perfect maze with one-cell corridors
+  RANDOM_DENSITY,   // each cell blocked with probability `density`
+  CLUTTERED         // scattered furniture rectangles
+};
+
+const char* layoutName(Layout layout);
+// Parse a name as printed by layoutName(); false if unknown
+bool parseLayout(const char* name, Layout& layout);
+
+// Place the layout's obstacles in house. density only applies to
+// RANDOM_DENSITY.
+void applyLayout(House& house, Layout layout, uint32_t seed, float density = 0.2f);
+
+// Leave dirt on roughly `fraction` of the free cells, none elsewhere
+void scatterDirt(House& house, uint32_t seed, float fraction);
+
+#endif // LAYOUTS_H
@@ -0,0 +1,463 @@
+#include "PlannerBench.h"
+#include "FleetSim.h"
+#include "Layouts.h"
+#include "Algorithm.h"
+#include "GridSearch.h"
+#include "HierarchicalPlanner.h"
+#include "House.h"
+#include "VacuumCleaner.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <vector>
+
+// Every heap allocation in the program goes through here, so a query's
+// allocations are the difference of the counter around it. Atomic because
+// the fleet simulator allocates from several threads.
+static std::atomic<unsigned long> heapAllocs{0};
+
+void* operator new(std::size_t n) {
+  heapAllocs++;
+  if (void* p = std::malloc(n ? n : 1)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// Start poses per house for the repeated queries
+static const int POSES = 20;
+static const float DIRT_FRACTION = 0.02f;
+// Largest house the whole-charge rows run in; a COVERAGE charge in a
+// 256x256 maze replans for minutes
+static const int CHARGE_MAX_SIZE = 128;
+
+struct QueryStats {
+  int runs = 0;
+  double totalUs = 0, maxUs = 0;
+  unsigned long allocs = 0;
+  long expansions = 0, moves = 0, turns = 0;
+  double battery = 0;
+  long cleaned = 0;    // cells, for the rows that run whole charges
+  size_t bytes = 0;    // planner memory, for the rows that run one directly
+
+  void add(double us, unsigned long a, long expanded) {
+    runs++;
+    totalUs += us;
+    if (us > maxUs) maxUs = us;
+    allocs += a;
+    expansions += expanded;
+  }
+
+  void add(double us, unsigned long a, const Algorithm& algo) {
+    add(us, a, algo.getLastExpansions());
+    moves += algo.getPlanEstimate().moves;
+    turns += algo.getPlanEstimate().rotations;
+    battery += algo.getPlanEstimate().battery.toFloat();
+  }
+};
+
+struct Row {
+  const char* layout;
+  int size;
+  uint32_t seed;
+  const char* query;
+  QueryStats s;
+};
+
+static void timedPlan(Algorithm& algo, QueryStats& stats) {
+  unsigned long a0 = heapAllocs;
+  auto t0 = std::chrono::steady_clock::now();
+  algo.calculateNextMove();
+  double us = std::chrono::duration<double, std::micro>(
+    std::chrono::steady_clock::now() - t0).count();
+  stats.add(us, heapAllocs - a0, algo);
+}
+
+// Same engine and queries as Algorithm, run against each priority queue:
+// the whole-map reverse field behind the return-home path, and a Dijkstra
+// from a pose to the nearest dirt
+template <typename Cost>
+struct FieldSweep {
+  static const bool REVERSE = true;
+  bool isGoal(int, int) const { return false; }
+  Cost heuristic(int, int) const { return 0; }
+};
+
+template <typename Cost>
+struct NearestDirtSweep {
+  static const bool REVERSE = false;
+  const GridMap& map;
+  bool isGoal(int x, int y) const { return map.dirtAt(x, y) > 0; }
+  Cost heuristic(int, int) const { return 0; }
+};
+
+// Pose to cell A* on the grid, the flat counterpart of the hierarchical
+// planner
+struct ToCellSweep {
+  static const bool REVERSE = false;
+  int tx, ty;
+  PlanCost move;
+  bool isGoal(int x, int y) const { return x == tx && y == ty; }
+  PlanCost heuristic(int x, int y) const { return (abs(x - tx) + abs(y - ty)) * move; }
+};
+
+template <typename Cost, typename Queue>
+static void timedField(const GridMap& map, SearchWorkspace<Cost, Queue>& ws, Cost move,
+                       Cost rotate, QueryStats& stats) {
+  unsigned long a0 = heapAllocs;
+  auto t0 = std::chrono::steady_clock::now();
+  ws.reset();
+  ws.pops = 0;
+  for (int h = 0; h < NUM_HEADINGS; h++) ws.seed(h, Cost(0));
+  searchStates(ws, map, FieldSweep<Cost>{}, move, rotate);
+  double us = std::chrono::duration<double, std::micro>(
+    std::chrono::steady_clock::now() - t0).count();
+  stats.add(us, heapAllocs - a0, ws.pops);
+}
+
+// Cost of the nearest dirt from state `start`, or unreachable
+template <typename Cost, typename Queue>
+static Cost timedNearest(const GridMap& map, SearchWorkspace<Cost, Queue>& ws, int start,
+                         Cost move, Cost rotate, QueryStats& stats) {
+  unsigned long a0 = heapAllocs;
+  auto t0 = std::chrono::steady_clock::now();
+  ws.reset();
+  ws.pops = 0;
+  ws.seed(start, Cost(0));
+  int goal = searchStates(ws, map, NearestDirtSweep<Cost>{map}, move, rotate);
+  double us = std::chrono::duration<double, std::micro>(
+    std::chrono::steady_clock::now() - t0).count();
+  stats.add(us, heapAllocs - a0, ws.pops);
+  return goal < 0 ? unreachableCost<Cost>() : ws.cost[goal];
+}
+
+static void timedAStar(const GridMap& map, SearchWorkspace<PlanCost>& ws, int x, int y,
+                       int tx, int ty, PlanCost move, PlanCost rotate, QueryStats& stats) {
+  unsigned long a0 = heapAllocs;
+  auto t0 = std::chrono::steady_clock::now();
+  ToCellSweep goal{tx, ty, move};
+  int start = map.index(x, y) * NUM_HEADINGS;
+  ws.reset();
+  ws.pops = 0;
+  ws.seed(start, goal.heuristic(x, y));
+  int s = searchStates(ws, map, goal, move, rotate);
+  double us = std::chrono::duration<double, std::micro>(
+    std::chrono::steady_clock::now() - t0).count();
+  stats.add(us, heapAllocs - a0, ws.pops);
+  for (; s >= 0 && s != start; s = ws.parent[s]) ++(ws.turn[s] == 0 ? stats.moves : stats.turns);
+  stats.bytes = ws.memoryBytes();
+}
+
+// One charge in the house of the given layout and seed, planned in mode.
+// The time covers the whole charge, and battery is the charge spent.
+static void timedCharge(Layout layout, int size, uint32_t seed, float density,
+                        PlannerMode mode, QueryStats& stats) {
+  MissionParams p;
+  p.size = size;
+  p.layout = layout;
+  p.density = density;
+  p.mode = mode;
+  unsigned long a0 = heapAllocs;
+  auto t0 = std::chrono::steady_clock::now();
+  MissionResult r = runMission(p, seed);
+  double us = std::chrono::duration<double, std::micro>(
+    std::chrono::steady_clock::now() - t0).count();
+  stats.add(us, heapAllocs - a0, 0L);
+  stats.cleaned += r.cellsCovered;
+  stats.battery += 100.0 - r.batteryLeft;
+}
+
+// Moves and turns are those of the whole path, though only the first leg
+// is refined
+static void timedHierarchical(HierarchicalPlanner& planner, int x, int y, int tx, int ty,
+                              std::vector<int8_t>& out, QueryStats& stats) {
+  unsigned long a0 = heapAllocs;
+  auto t0 = std::chrono::steady_clock::now();
+  out.clear();
+  bool found = planner.plan(x, y, 0, tx, ty, out);
+  double us = std::chrono::duration<double, std::micro>(
+    std::chrono::steady_clock::now() - t0).count();
+  stats.add(us, heapAllocs - a0, planner.getLastExpansions());
+  if (found) {
+    stats.moves += planner.getLastMoves();
+    stats.turns += planner.getLastTurns();
+  }
+  stats.bytes = planner.memoryBytes();
+}
+
+static void benchHouse(Layout layout, int size, uint32_t seed, float density,
+                       std::vector<Row>& rows) {
+  House house(size, size, seed);
+  applyLayout(house, layout, seed, density);
+  scatterDirt(house, seed, DIRT_FRACTION);
+  VacuumCleaner vacuum(&house);
+  Algorithm algo(&house, &vacuum);
+
+  std::minstd_rand rng(seed);
+  std::vector<std::pair<int, int>> poses;
+  while (int(poses.size()) < POSES) {
+    int x = int(rng() % size), y = int(rng() % size);
+    if (!house.isObstacle(x, y)) poses.push_back({x, y});
+  }
+
+  const char* name = layoutName(layout);
+  Row cold{name, size, seed, "return_cold", {}};
+  Row warm{name, size, seed, "return_warm", {}};
+  Row returnJump{name, size, seed, "return_jump", {}};
+  Row returnHpa{name, size, seed, "return_hpa", {}};
+  Row clean{name, size, seed, "clean_full", {}};
+  Row cleanJump{name, size, seed, "clean_full_jump", {}};
+  Row incr{name, size, seed, "clean_incremental", {}};
+  const PlanCost move = toPlanCost(2.0f), rotate = toPlanCost(1.5f);
+
+  // Jump point search has to find plans of the same cost as the grid search
+  std::vector<PlanCost> gridCosts;
+  auto planCost = [&]() {
+    const PlanEstimate& e = algo.getPlanEstimate();
+    return e.moves * move + e.rotations * rotate;
+  };
+  auto checkJump = [&](const Row& row, size_t i) {
+    if (planCost() == gridCosts[i]) return;
+    fprintf(stderr, "%s %d seed %u: %s plan costs %d instead of %d at (%d,%d)\n", name, size,
+            (unsigned)seed, row.query, planCost(), gridCosts[i], poses[i].first, poses[i].second);
+  };
+
+  algo.setObjective(AlgorithmObjective::RETURN_HOME);
+  vacuum.setPose(poses[0].first, poses[0].second, 0);
+  timedPlan(algo, cold.s);
+  for (auto& p : poses) {
+    vacuum.setPose(p.first, p.second, 0);
+    timedPlan(algo, warm.s);
+    gridCosts.push_back(planCost());
+  }
+  algo.setSearchMethod(AlgorithmObjective::RETURN_HOME, SearchMethod::JUMP_POINT);
+  for (size_t i = 0; i < poses.size(); i++) {
+    vacuum.setPose(poses[i].first, poses[i].second, 0);
+    timedPlan(algo, returnJump.s);
+    checkJump(returnJump, i);
+  }
+  algo.setSearchMethod(AlgorithmObjective::RETURN_HOME, SearchMethod::HIERARCHICAL);
+  for (auto& p : poses) {
+    vacuum.setPose(p.first, p.second, 0);
+    timedPlan(algo, returnHpa.s);
+  }
+
+  algo.setObjective(AlgorithmObjective::CLEANING);
+  algo.setPlannerMode(PlannerMode::FULL_REPLAN);
+  gridCosts.clear();
+  for (auto& p : poses) {
+    vacuum.setPose(p.first, p.second, 0);
+    timedPlan(algo, clean.s);
+    gridCosts.push_back(planCost());
+  }
+  algo.setSearchMethod(AlgorithmObjective::CLEANING, SearchMethod::JUMP_POINT);
+  for (size_t i = 0; i < poses.size(); i++) {
+    vacuum.setPose(poses[i].first, poses[i].second, 0);
+    timedPlan(algo, cleanJump.s);
+    checkJump(cleanJump, i);
+  }
+  algo.setPlannerMode(PlannerMode::INCREMENTAL);
+  for (auto& p : poses) {
+    vacuum.setPose(p.first, p.second, 0);
+    timedPlan(algo, incr.s);
+  }
+
+  // Replans alternating nearest dirt and home, as in a charge. Fresh builds
+  // a new Algorithm, and with it every workspace, for each one; reused
+  // keeps one Algorithm, like the firmware, and must not allocate once
+  // the home field is built. Replans per second are 1e6 / mean_us.
+  Row replanFresh{name, size, seed, "replan_fresh", {}};
+  Row replanReused{name, size, seed, "replan_reused", {}};
+  Algorithm reused(&house, &vacuum);
+  reused.setObjective(AlgorithmObjective::RETURN_HOME);
+  reused.calculateNextMove();
+  for (size_t i = 0; i < poses.size(); i++) {
+    AlgorithmObjective objective = i % 2 ? AlgorithmObjective::RETURN_HOME
+                                         : AlgorithmObjective::CLEANING;
+    vacuum.setPose(poses[i].first, poses[i].second, 0);
+    unsigned long a0 = heapAllocs;
+    auto t0 = std::chrono::steady_clock::now();
+    {
+      Algorithm fresh(&house, &vacuum);
+      fresh.setObjective(objective);
+      fresh.calculateNextMove();
+      double us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - t0).count();
+      replanFresh.s.add(us, heapAllocs - a0, fresh);
+    }
+    reused.setObjective(objective);
+    unsigned long before = replanReused.s.allocs;
+    timedPlan(reused, replanReused.s);
+    if (replanReused.s.allocs != before) {
+      fprintf(stderr, "%s %d seed %u: replan_reused allocated %lu times at (%d,%d)\n", name,
+              size, (unsigned)seed, replanReused.s.allocs - before, poses[i].first,
+              poses[i].second);
+    }
+  }
+
+  Row fieldFloat{name, size, seed, "field_float", {}};
+  Row fieldHeap{name, size, seed, "field_heap", {}};
+  Row fieldBucket{name, size, seed, "field_bucket", {}};
+  Row nearestHeap{name, size, seed, "nearest_heap", {}};
+  Row nearestBucket{name, size, seed, "nearest_bucket", {}};
+  const int numStates = size * size * NUM_HEADINGS;
+  SearchWorkspace<float> wsFloat;
+  SearchWorkspace<PlanCost, BinaryHeap<PlanCost>> wsHeap;
+  SearchWorkspace<PlanCost, BucketQueue<PlanCost>> wsBucket;
+  wsFloat.resize(numStates, 2.0f, 1.5f);
+  wsHeap.resize(numStates, move, rotate);
+  wsBucket.resize(numStates, move, rotate);
+  for (int i = 0; i < POSES; i++) {
+    timedField(house.cells(), wsFloat, 2.0f, 1.5f, fieldFloat.s);
+    timedField(house.cells(), wsHeap, move, rotate, fieldHeap.s);
+    timedField(house.cells(), wsBucket, move, rotate, fieldBucket.s);
+  }
+  for (auto& p : poses) {
+    int start = (p.second * size + p.first) * NUM_HEADINGS;
+    PlanCost a = timedNearest(house.cells(), wsHeap, start, move, rotate, nearestHeap.s);
+    PlanCost b = timedNearest(house.cells(), wsBucket, start, move, rotate, nearestBucket.s);
+    if (a != b) {
+      fprintf(stderr, "%s %d seed %u: heap and bucket queue disagree at (%d,%d)\n",
+              name, size, (unsigned)seed, p.first, p.second);
+    }
+  }
+  fieldFloat.s.bytes = wsFloat.memoryBytes();
+  fieldHeap.s.bytes = nearestHeap.s.bytes = wsHeap.memoryBytes();
+  fieldBucket.s.bytes = nearestBucket.s.bytes = wsBucket.memoryBytes();
+
+  // Pose to home, flat against hierarchical. hpa_build is the first plan,
+  // which builds every cluster; hpa_touch flips one random cell before
+  // each plan, so only the clusters around it are rebuilt.
+  Row astarFlat{name, size, seed, "astar_flat", {}};
+  Row hpaBuild{name, size, seed, "hpa_build", {}};
+  Row hpa{name, size, seed, "hpa", {}};
+  Row hpaTouch{name, size, seed, "hpa_touch", {}};
+  SearchWorkspace<PlanCost> wsFlat;
+  wsFlat.resize(numStates, move, rotate);
+  HierarchicalPlanner planner(move, rotate, size, size);
+  for (int y = 0; y < size; y++)
+    for (int x = 0; x < size; x++) planner.setObstacle(x, y, house.isObstacle(x, y));
+  std::vector<int8_t> steps;
+  timedHierarchical(planner, poses[0].first, poses[0].second, 0, 0, steps, hpaBuild.s);
+  for (auto& p : poses) {
+    timedAStar(house.cells(), wsFlat, p.first, p.second, 0, 0, move, rotate, astarFlat.s);
+    timedHierarchical(planner, p.first, p.second, 0, 0, steps, hpa.s);
+  }
+  for (auto& p : poses) {
+    int x = int(rng() % size), y = int(rng() % size);
+    bool blocked = house.isObstacle(x, y);
+    if ((x == 0 && y == 0) || (x == p.first && y == p.second)) continue;
+    planner.setObstacle(x, y, !blocked);
+    timedHierarchical(planner, p.first, p.second, 0, 0, steps, hpaTouch.s);
+    // Rebuild outside the timing, so each plan only pays for its own cell
+    planner.setObstacle(x, y, blocked);
+    planner.plan(p.first, p.second, 0, 0, 0, steps);
+  }
+
+  // A whole charge with the coverage tour against greedy nearest-dirt
+  Row chargeCoverage{name, size, seed, "clean_coverage", {}};
+  Row chargeGreedy{name, size, seed, "clean_greedy", {}};
+  if (size <= CHARGE_MAX_SIZE) {
+    timedCharge(layout, size, seed, density, PlannerMode::COVERAGE, chargeCoverage.s);
+    timedCharge(layout, size, seed, density, PlannerMode::FULL_REPLAN, chargeGreedy.s);
+  }
+
+  rows.push_back(cold);
+  rows.push_back(warm);
+  rows.push_back(returnJump);
+  rows.push_back(returnHpa);
+  rows.push_back(clean);
+  rows.push_back(cleanJump);
+  rows.push_back(incr);
+  rows.push_back(replanFresh);
+  rows.push_back(replanReused);
+  rows.push_back(fieldFloat);
+  rows.push_back(fieldHeap);
+  rows.push_back(fieldBucket);
+  rows.push_back(nearestHeap);
+  rows.push_back(nearestBucket);
+  rows.push_back(astarFlat);
+  rows.push_back(hpaBuild);
+  rows.push_back(hpa);
+  rows.push_back(hpaTouch);
+  if (size <= CHARGE_MAX_SIZE) {
+    rows.push_back(chargeCoverage);
+    rows.push_back(chargeGreedy);
+  }
+}
+
+static void printCsv(const std::vector<Row>& rows) {
+  printf("layout,size,seed,query,runs,mean_us,max_us,allocs,expansions,moves,turns,battery,"
+         "cleaned,bytes\n");
+  for (const Row& r : rows) {
+    const QueryStats& s = r.s;
+    double n = s.runs ? s.runs : 1;
+    printf("%s,%d,%u,%s,%d,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.2f,%.1f,%zu\n",
+           r.layout, r.size, (unsigned)r.seed, r.query, s.runs,
+           s.totalUs / n, s.maxUs, s.allocs / n, s.expansions / n,
+           s.moves / n, s.turns / n, s.battery / n, s.cleaned / n, s.bytes);
+  }
+}
+
+static void printJson(const std::vector<Row>& rows) {
+  printf("[\n");
+  for (size_t i = 0; i < rows.size(); i++) {
+    const Row& r = rows[i];
+    const QueryStats& s = r.s;
+    double n = s.runs ? s.runs : 1;
+    printf("  {\"layout\": \"%s\", \"size\": %d, \"seed\": %u, \"query\": \"%s\", "
+           "\"runs\": %d, \"mean_us\": %.1f, \"max_us\": %.1f, \"allocs\": %.1f, "
+           "\"expansions\": %.1f, \"moves\": %.1f, \"turns\": %.1f, \"battery\": %.2f, "
+           "\"cleaned\": %.1f, \"bytes\": %zu}%s\n",
+           r.layout, r.size, (unsigned)r.seed, r.query, s.runs,
+           s.totalUs / n, s.maxUs, s.allocs / n, s.expansions / n,
+           s.moves / n, s.turns / n, s.battery / n, s.cleaned / n, s.bytes,
+           i + 1 < rows.size() ? "," : "");
+  }
+  printf("]\n");
+}
+
+int runPlannerBench(int argc, char** argv) {
+  bool json = false;
+  int seeds = 3;
+  float density = 0.2f;
+  std::vector<int> sizes = {20, 64, 128, 256};
+  std::vector<Layout> layouts = {Layout::EMPTY, Layout::ROOMS, Layout::MAZE,
+                                 Layout::RANDOM_DENSITY, Layout::CLUTTERED};
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--json")) {
+      json = true;
+    } else if (!strcmp(argv[i], "--seeds") && i + 1 < argc) {
+      seeds = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--density") && i + 1 < argc) {
+      density = float(atof(argv[++i]));
+    } else if (!strcmp(argv[i], "--sizes") && i + 1 < argc) {
+      sizes.clear();
+      for (char* tok = strtok(argv[++i], ","); tok; tok = strtok(nullptr, ","))
+        sizes.push_back(atoi(tok));
+    } else if (!strcmp(argv[i], "--layouts") && i + 1 < argc) {
+      layouts.clear();
+      for (char* tok = strtok(argv[++i], ","); tok; tok = strtok(nullptr, ",")) {
+        Layout l;
+        if (!parseLayout(tok, l)) {
+          fprintf(stderr, "unknown layout %s\n", tok);
+          return 1;
+        }
+        layouts.push_back(l);
+      }
+    }
+  }
+
+  std::vector<Row> rows;
+  for (Layout layout : layouts)
+    for (int size : sizes)
+      for (int seed = 1; seed <= seeds; seed++)
+        benchHouse(layout, size, uint32_t(seed), density, rows);
+  if (json) printJson(rows);
+  else      printCsv(rows);
+  return 0;
+}
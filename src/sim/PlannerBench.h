@@ -0,0 +1,23 @@
+// Host benchmark of the Algorithm planners over seeded layouts
+#ifndef PLANNER_BENCH_H
+#define PLANNER_BENCH_H
+
+// program --bench [--json] [--seeds N] [--sizes 20,64,128] [--layouts maze,rooms]
+//                 [--density D]
+// Writes one CSV (or JSON) row per layout, size, seed and query to stdout.
+// --density sets the share of blocked cells in the random layout. The
+// *_heap and *_bucket rows run the same search on each priority queue;
+// the *_jump rows repeat the row before them with jump point search. Both
+// pairs report on stderr wherever their costs differ. astar_flat and the
+// hpa_* rows plan from each pose to home on the grid and through the
+// HPA* cluster graph; bytes is the memory of the planner such rows run
+// directly, 0 for rows that go through Algorithm. clean_coverage and
+// clean_greedy each run one charge of the fleet simulator's mission in the
+// same house, with the COVERAGE tour and with FULL_REPLAN's nearest dirt:
+// cleaned is the cells cleaned and battery the percent spent. They only
+// run in houses of up to 128 cells a side. replan_fresh and replan_reused
+// alternate nearest-dirt and return-home replans from the same poses,
+// with a new Algorithm per replan and with one kept across them.
+int runPlannerBench(int argc, char** argv);
+
+#endif // PLANNER_BENCH_H
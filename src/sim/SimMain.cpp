@@ -0,0 +1,103 @@
+// Host entry point for the native env: runs the firmware's setup()/loop()
+// headless against the NativeHal shim, on a virtual clock by default.
+//
+//   .pio/build/native/program [sim-hours] [--realtime] [--serial]
+//   .pio/build/native/program --decode <log.bin>   print a binary event log
+//   .pio/build/native/program --bench [options]    planner benchmark, see
+//                                                  PlannerBench.h
+//   .pio/build/native/program --fleet [options]    parallel mission batch,
+//                                                  see FleetSim.h
+//   .pio/build/native/program --tune [options]     battery/planner tuner,
+//                                                  see Tuner.h
+//   .pio/build/native/program --fixed-check        fixed point vs float,
+//                                                  see FixedCheck.h
+
+#include <Arduino.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#include "Constants.h"
+#include "Fixed.h"
+#include "FixedCheck.h"
+#include "FleetSim.h"
+#include "Grid.h"
+#include "Logger.h"
+#include "PlannerBench.h"
+#include "Tuner.h"
+
+void setup();
+void loop();
+
+extern bool  autoMode;
+extern bool  returningHome;
+extern Battery batteryLevel;
+extern Grid  grid;
+
+// Turn a dump written by Logger::drainBinary() back into text
+static int decodeLog(const char* path) {
+  FILE* f = fopen(path, "rb");
+  if (!f) {
+    fprintf(stderr, "cannot open %s\n", path);
+    return 1;
+  }
+  uint8_t header[6];
+  if (fread(header, 1, sizeof(header), f) != sizeof(header) ||
+      memcmp(header, "RLOG", 4) != 0 || header[5] != sizeof(LogRecord)) {
+    fprintf(stderr, "%s is not a binary event log\n", path);
+    fclose(f);
+    return 1;
+  }
+  LogRecord r;
+  char line[64];
+  while (fread(&r, sizeof(r), 1, f) == 1) {
+    Logger::format(r, line, sizeof(line));
+    puts(line);
+  }
+  fclose(f);
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  double hours = 1.0;
+  WallClock wallClock;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--decode") && i + 1 < argc) return decodeLog(argv[i + 1]);
+    if (!strcmp(argv[i], "--bench")) return runPlannerBench(argc, argv);
+    if (!strcmp(argv[i], "--fleet")) return runFleetSim(argc, argv);
+    if (!strcmp(argv[i], "--tune"))  return runTuner(argc, argv);
+    if (!strcmp(argv[i], "--fixed-check")) return runFixedCheck(argc, argv);
+    if (!strcmp(argv[i], "--realtime"))    setSimClock(&wallClock);
+    else if (!strcmp(argv[i], "--serial")) halEchoSerial(true);
+    else                                   hours = atof(argv[i]);
+  }
+
+  // Joystick centred, button released
+  halSetAnalog(JOY_VRX, 2048);
+  halSetAnalog(JOY_VRY, 2048);
+
+  auto t0 = std::chrono::steady_clock::now();
+  setup();
+  halSetDigital(JOY_SW, HIGH);
+
+  const uint64_t endUs = uint64_t(hours * 3600.0 * 1e6);
+  unsigned long loops = 0;
+  while (simClock().nowMicros() < endUs) {
+    // Press the button once to switch to AUTO
+    halSetDigital(JOY_SW, (!autoMode && loops > 0) ? LOW : HIGH);
+    loop();
+    loops++;
+  }
+  double wall = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - t0).count();
+
+  long dirt = 0;
+  for (int y = 0; y < grid.height(); y++)
+    for (int x = 0; x < grid.width(); x++) dirt += grid.dirtAt(x, y);
+
+  printf("simulated %.2f h in %.3f s (%.0fx real time), %lu loops\n",
+         hours, wall, hours * 3600.0 / wall, loops);
+  printf("battery %.1f%%, returning home %d, total dirt %ld\n",
+         batteryLevel.toFloat(), returningHome, dirt);
+  return 0;
+}
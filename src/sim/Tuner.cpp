@@ -0,0 +1,142 @@
+#include "Tuner.h"
+#include "FleetSim.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Search space; the move weight stays at PLAN_COST_MOVE since only the
+// ratio of the two weights changes the paths
+static const float MARGINS[] = {0, 2, 4, 6, 8, 10, 15, 20, 25, 30, 40, 50};
+static const float ROTATE_WEIGHTS[] = {0.5f, 1.0f, 1.5f, 2.0f, 3.0f, 4.0f};
+static const float LOW_THRESHOLDS[] = {15, 25, 35};
+static const int SHOW_BEST = 10;
+
+struct Candidate {
+  RobotConfig config;
+  double score = 0;      // mean dirt removed per charge
+  double stranded = 0;   // % of missions
+  double coverage = 0;   // % of free cells
+};
+
+static bool writeHeader(const char* path, const Candidate& best, int missions,
+                        const std::string& command) {
+  FILE* f = fopen(path, "w");
+  if (!f) return false;
+  fprintf(f, "// Generated by `%s`; do not edit.\n", command.c_str());
+  fprintf(f, "// %.1f dirt removed per charge, %.1f%% stranded over %d missions\n",
+          best.score, best.stranded, missions);
+  fprintf(f, "#ifndef TUNED_CONSTANTS_H\n#define TUNED_CONSTANTS_H\n\n");
+  auto define = [f](const char* name, float v) {
+    fprintf(f, "#undef  %s\n#define %s %.2ff\n", name, name, v);
+  };
+  define("BAT_LOW_THRESHOLD", best.config.lowThreshold.toFloat());
+  define("BAT_HOME_MARGIN", best.config.homeMargin.toFloat());
+  define("PLAN_COST_MOVE", best.config.planner.move);
+  define("PLAN_COST_ROTATE", best.config.planner.rotate);
+  fprintf(f, "\n#endif // TUNED_CONSTANTS_H\n");
+  fclose(f);
+  return true;
+}
+
+int runTuner(int argc, char** argv) {
+  int missions = 100;
+  unsigned threads = std::thread::hardware_concurrency();
+  const char* out = nullptr;
+  MissionParams base;
+  std::string command = "program";
+  for (int i = 1; i < argc; i++) {
+    command += std::string(" ") + argv[i];
+  }
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--missions") && i + 1 < argc) {
+      missions = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+      threads = unsigned(atoi(argv[++i]));
+    } else if (!strcmp(argv[i], "--size") && i + 1 < argc) {
+      base.size = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--density") && i + 1 < argc) {
+      base.density = float(atof(argv[++i]));
+    } else if (!strcmp(argv[i], "--no-clean-on-return")) {
+      base.cleanOnReturn = false;
+    } else if (!strcmp(argv[i], "--out") && i + 1 < argc) {
+      out = argv[++i];
+    } else if (!strcmp(argv[i], "--layout") && i + 1 < argc) {
+      if (!parseLayout(argv[++i], base.layout)) {
+        fprintf(stderr, "unknown layout %s\n", argv[i]);
+        return 1;
+      }
+    } else if (!strcmp(argv[i], "--mode") && i + 1 < argc) {
+      if (!parsePlannerMode(argv[++i], base.mode)) {
+        fprintf(stderr, "unknown planner mode %s\n", argv[i]);
+        return 1;
+      }
+    }
+  }
+  if (missions <= 0) return 1;
+
+  std::vector<Candidate> candidates;
+  for (float low : LOW_THRESHOLDS) {
+    for (float rotate : ROTATE_WEIGHTS) {
+      for (float margin : MARGINS) {
+        Candidate c;
+        c.config.lowThreshold = Battery(low);
+        c.config.homeMargin = Battery(margin);
+        c.config.planner.rotate = rotate;
+        candidates.push_back(c);
+      }
+    }
+  }
+
+  // Every candidate runs the same seeds, so the differences between them
+  // are not drowned out by house-to-house variance
+  size_t jobs = candidates.size() * size_t(missions);
+  std::vector<MissionResult> results(jobs);
+  WorkStealingPool pool(threads);
+  auto t0 = std::chrono::steady_clock::now();
+  pool.run(jobs, [&](size_t i) {
+    MissionParams p = base;
+    p.config = candidates[i / missions].config;
+    results[i] = runMission(p, uint32_t(i % missions) + 1);
+  });
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  for (size_t c = 0; c < candidates.size(); c++) {
+    for (int m = 0; m < missions; m++) {
+      const MissionResult& r = results[c * missions + m];
+      if (!r.stranded) candidates[c].score += r.dirtRemoved;
+      candidates[c].stranded += r.stranded;
+      candidates[c].coverage += r.freeCells ? 100.0 * r.cellsCovered / r.freeCells : 0.0;
+    }
+    candidates[c].score /= missions;
+    candidates[c].stranded = 100.0 * candidates[c].stranded / missions;
+    candidates[c].coverage /= missions;
+  }
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const Candidate& a, const Candidate& b) { return a.score > b.score; });
+
+  printf("rank,low_threshold,home_margin,move_weight,rotate_weight,dirt_per_charge,"
+         "stranded_pct,coverage_pct\n");
+  for (int i = 0; i < SHOW_BEST && i < int(candidates.size()); i++) {
+    const Candidate& c = candidates[i];
+    printf("%d,%.1f,%.1f,%.2f,%.2f,%.1f,%.1f,%.1f\n", i + 1, c.config.lowThreshold.toFloat(),
+           c.config.homeMargin.toFloat(), c.config.planner.move, c.config.planner.rotate,
+           c.score, c.stranded, c.coverage);
+  }
+  fprintf(stderr, "%zu candidates x %d missions on %u threads in %.2f s\n",
+          candidates.size(), missions, pool.size(), secs);
+
+  if (out) {
+    if (!writeHeader(out, candidates[0], missions, command)) {
+      fprintf(stderr, "cannot write %s\n", out);
+      return 1;
+    }
+    fprintf(stderr, "wrote %s\n", out);
+  }
+  return 0;
+}
@@ -0,0 +1,15 @@
+// Grid search over the return threshold and planner weights on simulated
+// missions, exported as a header the firmware build picks up
+#ifndef TUNER_H
+#define TUNER_H
+
+// program --tune [--missions N] [--threads T] [--size S] [--layout L]
+//                [--density D] [--mode M] [--no-clean-on-return]
+//                [--out lib/Constants/TunedConstants.h]
+// Scores every candidate on the same N seeded missions by the mean dirt
+// removed per charge, counting a stranded mission as zero. Prints the best
+// candidates as CSV and, with --out, writes the winner as #defines that
+// override Constants.h.
+int runTuner(int argc, char** argv);
+
+#endif // TUNER_H
@@ -0,0 +1,66 @@
+// Fixed set of worker threads for independent, index-addressed jobs. Each
+// worker owns a deque of job indices and takes from its back; a worker that
+// runs dry steals from the front of the others.
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool {
+public:
+  explicit WorkStealingPool(unsigned threads)
+    : queues(threads ? threads : 1) {}
+
+  unsigned size() const { return unsigned(queues.size()); }
+
+  // Run job(0) .. job(jobs-1) and return once all have finished
+  void run(size_t jobs, const std::function<void(size_t)>& job) {
+    for (size_t i = 0; i < jobs; i++) queues[i % queues.size()].jobs.push_back(i);
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < queues.size(); w++) {
+      workers.emplace_back([this, w, &job] {
+        size_t i;
+        while (take(w, i)) job(i);
+      });
+    }
+    for (std::thread& t : workers) t.join();
+  }
+
+private:
+  struct Queue {
+    std::mutex lock;
+    std::deque<size_t> jobs;
+  };
+
+  bool take(unsigned w, size_t& job) {
+    {
+      std::lock_guard<std::mutex> g(queues[w].lock);
+      if (!queues[w].jobs.empty()) {
+        job = queues[w].jobs.back();
+        queues[w].jobs.pop_back();
+        return true;
+      }
+    }
+    // Jobs are only ever queued up front, so once every queue is empty
+    // there is nothing left to steal
+    for (unsigned k = 1; k < queues.size(); k++) {
+      Queue& victim = queues[(w + k) % queues.size()];
+      std::lock_guard<std::mutex> g(victim.lock);
+      if (!victim.jobs.empty()) {
+        job = victim.jobs.front();
+        victim.jobs.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::vector<Queue> queues;
+};
+
+#endif // WORK_STEALING_POOL_H
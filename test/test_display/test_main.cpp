@@ -0,0 +1,135 @@
+// Host test: tiled rendering must put exactly the pixels on screen that
+// the per-cell renderer does, and both must shade dirt the way the
+// original formula did. The native Adafruit_ILI9341 keeps a
+// framebuffer, which is read back after each mode has drawn the same Grid.
+//   pio test -e native
+#include <unity.h>
+#include <vector>
+#include "Display.h"
+#include "Grid.h"
+
+struct Pose {
+  int x, y, dir;
+};
+
+void setUp() {}
+void tearDown() {}
+
+static std::vector<uint16_t> framebuffer() {
+  std::vector<uint16_t> pixels;
+  pixels.reserve(size_t(tft.width()) * tft.height());
+  for (int y = 0; y < tft.height(); y++)
+    for (int x = 0; x < tft.width(); x++) pixels.push_back(tft.getPixel(x, y));
+  return pixels;
+}
+
+// Every dirt level across the floor, a few obstacles, and the dock at
+// (0,0) left clean
+static void paintFloor(Grid &grid) {
+  for (int y = 0; y < grid.height(); y++)
+    for (int x = 0; x < grid.width(); x++) grid.setDirt(x, y, (x + 2*y) % (MAX_DIRT + 1));
+  grid.setDirt(0, 0, 0);
+  const int obstacles[][2] = {{3, 3}, {4, 3}, {5, 3}, {10, 12}, {10, 13}, {18, 1}, {8, 7}};
+  for (const auto &o : obstacles) grid.toggleObstacle(o[0], o[1]);
+}
+
+// Draw the first pose on a blank screen, then every later one as an
+// update, the robot cleaning its cell after each frame
+static std::vector<uint16_t> render(bool tiled, const Pose *poses, int count) {
+  Grid grid(GRID_SIZE, GRID_SIZE);
+  paintFloor(grid);
+  tft.fillScreen(ILI9341_BLACK);
+  setTiledRendering(tiled);
+  for (int i = 0; i < count; i++) {
+    drawGrid(poses[i].x, poses[i].y, grid, poses[i].dir);
+    grid.setDirt(poses[i].x, poses[i].y, 0);
+  }
+  return framebuffer();
+}
+
+static void assertSameFrame(const Pose *poses, int count) {
+  std::vector<uint16_t> cells = render(false, poses, count);
+  std::vector<uint16_t> tiles = render(true, poses, count);
+  TEST_ASSERT_EQUAL_HEX16_ARRAY(cells.data(), tiles.data(), cells.size());
+}
+
+// The shading the dirt lookup table was built from, kept here so a table
+// that drifts from it is caught
+static uint16_t originalShade(int d) {
+  auto clamp = [](int v, int lo, int hi) { return v < lo ? lo : v > hi ? hi : v; };
+  int r = clamp(255 - d*15, 101, 255),
+      g = clamp(255 - d*23,  67, 255),
+      b = clamp(255 - d*30,  33, 255);
+  return uint16_t(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
+
+// Every floor cell must be filled with the original shade of its dirt
+static void test_dirt_shading() {
+  Grid grid(GRID_SIZE, GRID_SIZE);
+  paintFloor(grid);
+  const Pose pose = {0, 0, 1};
+  for (int tiled = 0; tiled < 2; tiled++) {
+    std::vector<uint16_t> frame = render(tiled, &pose, 1);
+    std::vector<uint16_t> expected = frame;
+    for (int y = 0; y < VIEW_CELLS; y++)
+      for (int x = 0; x < VIEW_CELLS; x++) {
+        if ((x == pose.x && y == pose.y) || grid.isObstacle(x, y)) continue;
+        uint16_t shade = originalShade(grid.dirtAt(x, y));
+        for (int j = 0; j < CELL_SIZE; j++)
+          for (int i = 0; i < CELL_SIZE; i++)
+            expected[size_t(y*CELL_SIZE + HEADER_HEIGHT + j) * tft.width() + x*CELL_SIZE + i] = shade;
+      }
+    TEST_ASSERT_EQUAL_HEX16_ARRAY(expected.data(), frame.data(), frame.size());
+  }
+}
+
+static void test_robot_on_dock() {
+  for (int dir = 0; dir < 4; dir++) {
+    Pose pose = {0, 0, dir};
+    assertSameFrame(&pose, 1);
+  }
+}
+
+static void test_robot_between_obstacles_and_dirt() {
+  const Pose poses[] = {{6, 3, 1}, {9, 7, 3}, {10, 11, 2}, {19, 5, 0}, {0, 10, 3}};
+  for (const Pose &pose : poses) assertSameFrame(&pose, 1);
+}
+
+static void test_updates_while_driving() {
+  // Drive, turn on the spot, pass obstacles and return to the dock
+  const Pose route[] = {{0, 0, 0}, {0, 0, 1}, {1, 0, 1}, {2, 0, 1}, {2, 0, 2},
+                        {2, 1, 2}, {2, 2, 2}, {2, 2, 1}, {3, 2, 1}, {4, 2, 1},
+                        {4, 2, 3}, {3, 2, 3}, {2, 2, 3}, {2, 2, 0}, {2, 1, 0},
+                        {2, 0, 0}, {2, 0, 3}, {1, 0, 3}, {0, 0, 3}};
+  for (int n = 1; n <= int(sizeof(route) / sizeof(route[0])); n++) assertSameFrame(route, n);
+}
+
+// Cleaning the cell under the robot without moving or turning must still
+// repaint the floor around it
+static void test_cleaning_in_place() {
+  for (int tiled = 0; tiled < 2; tiled++) {
+    Grid grid(GRID_SIZE, GRID_SIZE);
+    paintFloor(grid);
+    tft.fillScreen(ILI9341_BLACK);
+    setTiledRendering(tiled);
+    drawGrid(1, 0, grid, 1);
+    grid.setDirt(1, 0, 0);
+    drawGrid(1, 0, grid, 1);
+    std::vector<uint16_t> updated = framebuffer();
+    setTiledRendering(tiled);
+    drawGrid(1, 0, grid, 1);
+    std::vector<uint16_t> repainted = framebuffer();
+    TEST_ASSERT_EQUAL_HEX16_ARRAY(repainted.data(), updated.data(), repainted.size());
+  }
+}
+
+int main(int, char **) {
+  setupDisplay();
+  UNITY_BEGIN();
+  RUN_TEST(test_dirt_shading);
+  RUN_TEST(test_robot_on_dock);
+  RUN_TEST(test_robot_between_obstacles_and_dirt);
+  RUN_TEST(test_cleaning_in_place);
+  RUN_TEST(test_updates_while_driving);
+  return UNITY_END();
+}